@@ -3,6 +3,7 @@
 #include "common/printing.h"
 #include "common/time.h"
 #include "common/jsonconfig.h"
+#include "common/preload.h"
 #include "fastfetch_datatext.h"
 #include "modules/modules.h"
 #include "util/stringUtils.h"
@@ -22,6 +23,21 @@ bool ffParseModuleOptions(const char* key, const char* value)
     return false;
 }
 
+static uint32_t countModuleInStructure(const FFstrbuf* structure, const char* moduleName)
+{
+    uint32_t count = 0;
+    uint32_t nameLength = (uint32_t) strlen(moduleName);
+    uint32_t startIndex = 0;
+    while (startIndex < structure->length)
+    {
+        uint32_t colonIndex = ffStrbufNextIndexC(structure, startIndex, ':');
+        if (colonIndex - startIndex == nameLength && strncasecmp(structure->chars + startIndex, moduleName, nameLength) == 0)
+            ++count;
+        startIndex = colonIndex + 1;
+    }
+    return count;
+}
+
 void ffPrepareCommandOption(FFdata* data)
 {
     FFOptionsModules* const options = &instance.config.modules;
@@ -40,11 +56,20 @@ void ffPrepareCommandOption(FFdata* data)
 
     if(instance.config.general.multithreading)
     {
-        if(ffStrbufContainIgnCaseS(&data->structure, FF_PUBLICIP_MODULE_NAME))
+        // Issue one request per module instance, so that all of them are in flight at the same time
+        for (uint32_t i = countModuleInStructure(&data->structure, FF_PUBLICIP_MODULE_NAME); i > 0; --i)
             ffPreparePublicIp(&options->publicIP);
 
-        if(ffStrbufContainIgnCaseS(&data->structure, FF_WEATHER_MODULE_NAME))
+        for (uint32_t i = countModuleInStructure(&data->structure, FF_WEATHER_MODULE_NAME); i > 0; --i)
             ffPrepareWeather(&options->weather);
+
+        uint32_t startIndex = 0;
+        while (startIndex < data->structure.length)
+        {
+            uint32_t colonIndex = ffStrbufNextIndexC(&data->structure, startIndex, ':');
+            ffPreloadModuleLibraries(data->structure.chars + startIndex, colonIndex - startIndex);
+            startIndex = colonIndex + 1;
+        }
     }
 }
 
@@ -410,3 +410,50 @@ void ffParseFormatString(FFstrbuf* buffer, const FFstrbuf* formatstr, uint32_t n
     if (!instance.config.display.pipe)
         ffStrbufAppendS(buffer, FASTFETCH_TEXT_MODIFIER_RESET);
 }
+
+bool ffFormatStringUsesArg(const FFstrbuf* formatstr, uint32_t index, const char* name)
+{
+    uint32_t argCounter = 0;
+
+    for (uint32_t i = 0; i < formatstr->length; ++i)
+    {
+        if (formatstr->chars[i] != '{')
+            continue;
+
+        ++i;
+        if (formatstr->chars[i] == '{')
+            continue;
+
+        uint32_t iEnd = ffStrbufNextIndexC(formatstr, i, '}');
+        const char* start = &formatstr->chars[i];
+        const char* end = &formatstr->chars[iEnd];
+        i = iEnd;
+
+        // Same rules as ffParseFormatString
+        bool isCondition = *start == '?' || *start == '/';
+        if (isCondition)
+            ++start;
+        else if (*start == '#' || *start == '$' || (*start == '-' && end - start == 1))
+            continue;
+
+        const char* sep = start;
+        while (sep < end && *sep != ':' && *sep != '<' && *sep != '>' && *sep != '~')
+            ++sep;
+        uint32_t length = (uint32_t) (sep - start);
+
+        if (length == 0)
+        {
+            if (!isCondition && ++argCounter == index)
+                return true;
+        }
+        else if (ffCharIsDigit(*start))
+        {
+            if (strtoul(start, NULL, 10) == index)
+                return true;
+        }
+        else if (strlen(name) == length && strncasecmp(start, name, length) == 0)
+            return true;
+    }
+
+    return false;
+}
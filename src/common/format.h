@@ -42,5 +42,7 @@ typedef struct FFformatarg
 
 void ffFormatAppendFormatArg(FFstrbuf* buffer, const FFformatarg* formatarg);
 void ffParseFormatString(FFstrbuf* buffer, const FFstrbuf* formatstr, uint32_t numArgs, const FFformatarg* arguments);
+// Tests if `formatstr` references the argument at `index` (1-based) named `name`, so that expensive values can be skipped if not
+bool ffFormatStringUsesArg(const FFstrbuf* formatstr, uint32_t index, const char* name);
 #define FF_PARSE_FORMAT_STRING_CHECKED(buffer, formatstr, arguments) \
     ffParseFormatString((buffer), (formatstr), sizeof(arguments) / sizeof(*arguments), (arguments));
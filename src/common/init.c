@@ -32,7 +32,7 @@ static void initState(FFstate* state)
     {
         // don't enable bright color if the terminal is in light mode
         FFTerminalThemeResult result;
-        if (ffDetectTerminalTheme(&result, true /* forceEnv for performance */) && !result.bg.dark)
+        if (ffDetectTerminalTheme(&result, true /* cached replies or env only, for performance */) && !result.bg.dark)
             state->terminalLightTheme = true;
     }
 }
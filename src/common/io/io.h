@@ -163,6 +163,37 @@ bool ffPathExpandEnv(const char* in, FFstrbuf* out);
 FF_C_SCANF(3, 4)
 const char* ffGetTerminalResponse(const char* request, int nParams, const char* format, ...);
 
+// Like ffGetTerminalResponse, but for requests whose replies are fixed for a terminal session (colors, versions).
+// Replies are cached in $XDG_RUNTIME_DIR, keyed by the controlling tty, the session and TERM.
+// If `cacheOnly` is true, the terminal is never queried
+FF_C_SCANF(4, 5)
+const char* ffGetTerminalResponseCached(bool cacheOnly, const char* request, int nParams, const char* format, ...);
+
+#ifndef _WIN32
+typedef struct FFTerminalQuery
+{
+    const char* request;
+    const char* responsePrefix; // Replies starting with it are assigned to this query. NULL matches any reply
+    FFstrbuf response; // All replies assigned to this query, concatenated
+} FFTerminalQuery;
+
+// Sends all requests in one write, followed by a DA1 request whose reply marks the end of all replies.
+// Replies of requests that the terminal doesn't support are missing
+const char* ffGetTerminalResponses(FFTerminalQuery* queries, uint32_t count);
+
+typedef struct FFTerminalReplyParser
+{
+    FFstrbuf seq;
+    uint8_t state; // FFTerminalParseState
+    bool bare; // The terminal removed the `\e`s of the current reply (Windows Terminal)
+    uint32_t current; // Index of the last query that a reply was assigned to
+} FFTerminalReplyParser;
+
+// Splits `data` into replies and assigns them to `queries`. Replies without `\e` are assigned with `\e` restored.
+// Returns true once the reply of the DA1 sentinel is seen
+bool ffTerminalParseReplies(FFTerminalReplyParser* parser, const char* data, uint32_t length, FFTerminalQuery* queries, uint32_t count);
+#endif
+
 // Not thread safe!
 bool ffSuppressIO(bool suppress);
 
@@ -7,6 +7,7 @@
 #include <termios.h>
 #include <dirent.h>
 #include <errno.h>
+#include <inttypes.h>
 #ifndef __APPLE__
 #include <poll.h>
 #else
@@ -180,80 +181,330 @@ void restoreTerm(void)
     tcsetattr(ftty, TCSAFLUSH, &oldTerm);
 }
 
-const char* ffGetTerminalResponse(const char* request, int nParams, const char* format, ...)
+static const char* openTerminal(void)
 {
+    if (ftty >= 0)
+        return NULL;
+
+    ftty = open("/dev/tty", O_RDWR | O_NOCTTY | O_CLOEXEC);
     if (ftty < 0)
-    {
-        ftty = open("/dev/tty", O_RDWR | O_NOCTTY | O_CLOEXEC);
-        if (ftty < 0)
-            return "open(\"/dev/tty\", O_RDWR | O_NOCTTY | O_CLOEXEC) failed";
-
-        if(tcgetattr(ftty, &oldTerm) == -1)
-            return "tcgetattr(STDIN_FILENO, &oldTerm) failed";
-
-        struct termios newTerm = oldTerm;
-        newTerm.c_lflag &= (tcflag_t) ~(ICANON | ECHO);
-        if(tcsetattr(ftty, TCSAFLUSH, &newTerm) == -1)
-            return "tcsetattr(STDIN_FILENO, TCSAFLUSH, &newTerm)";
-        atexit(restoreTerm);
-    }
+        return "open(\"/dev/tty\", O_RDWR | O_NOCTTY | O_CLOEXEC) failed";
 
-    ffWriteFDData(ftty, strlen(request), request);
+    if(tcgetattr(ftty, &oldTerm) == -1)
+        return "tcgetattr(STDIN_FILENO, &oldTerm) failed";
 
+    struct termios newTerm = oldTerm;
+    newTerm.c_lflag &= (tcflag_t) ~(ICANON | ECHO);
+    if(tcsetattr(ftty, TCSAFLUSH, &newTerm) == -1)
+        return "tcsetattr(STDIN_FILENO, TCSAFLUSH, &newTerm)";
+    atexit(restoreTerm);
+    return NULL;
+}
+
+static bool waitTerminal(void)
+{
     //Give the terminal some time to respond
     #ifndef __APPLE__
-    if(poll(&(struct pollfd) { .fd = ftty, .events = POLLIN }, 1, FF_IO_TERM_RESP_WAIT_MS) <= 0)
-        return "poll(/dev/tty) timeout or failed";
+    return poll(&(struct pollfd) { .fd = ftty, .events = POLLIN }, 1, FF_IO_TERM_RESP_WAIT_MS) > 0;
     #else
+    // On macOS, poll(/dev/tty) always returns immediately
+    // See also https://nathancraddock.com/blog/macos-dev-tty-polling/
+    fd_set rd;
+    FD_ZERO(&rd);
+    FD_SET(ftty, &rd);
+    return select(ftty + 1, &rd, NULL, NULL, &(struct timeval) { .tv_sec = FF_IO_TERM_RESP_WAIT_MS / 1000, .tv_usec = (FF_IO_TERM_RESP_WAIT_MS % 1000) * 1000 }) > 0;
+    #endif
+}
+
+typedef enum FFTerminalParseState
+{
+    FF_TERMINAL_PARSE_STATE_NONE,
+    FF_TERMINAL_PARSE_STATE_ESC,
+    FF_TERMINAL_PARSE_STATE_CSI, // \e[ ... final byte
+    FF_TERMINAL_PARSE_STATE_STRING, // \e] or \eP ... BEL or ST
+    FF_TERMINAL_PARSE_STATE_STRING_ESC,
+} FFTerminalParseState;
+
+// Returns true if `seq` is the reply of the DA1 sentinel
+static bool assignTerminalReply(const FFstrbuf* seq, FFTerminalQuery* queries, uint32_t count, uint32_t* current)
+{
+    if (ffStrbufStartsWithS(seq, "\e[?") && ffStrbufEndsWithC(seq, 'c'))
+        return true;
+
+    // Terminals reply in order, but skip requests they don't support
+    for (uint32_t i = *current; i < count; ++i)
     {
-        // On macOS, poll(/dev/tty) always returns immediately
-        // See also https://nathancraddock.com/blog/macos-dev-tty-polling/
-        fd_set rd;
-        FD_ZERO(&rd);
-        FD_SET(ftty, &rd);
-        if(select(ftty + 1, &rd, NULL, NULL, &(struct timeval) { .tv_sec = FF_IO_TERM_RESP_WAIT_MS / 1000, .tv_usec = (FF_IO_TERM_RESP_WAIT_MS % 1000) * 1000 }) <= 0)
-            return "select(/dev/tty) timeout or failed";
+        if (queries[i].responsePrefix == NULL || ffStrbufStartsWithS(seq, queries[i].responsePrefix))
+        {
+            ffStrbufAppend(&queries[i].response, seq);
+            *current = i;
+            break;
+        }
     }
-    #endif
+    return false;
+}
+
+bool ffTerminalParseReplies(FFTerminalReplyParser* parser, const char* data, uint32_t length, FFTerminalQuery* queries, uint32_t count)
+{
+    FFstrbuf* seq = &parser->seq;
+
+    for (uint32_t i = 0; i < length; ++i)
+    {
+        char c = data[i];
+        bool complete = false;
+
+        switch ((FFTerminalParseState) parser->state)
+        {
+            case FF_TERMINAL_PARSE_STATE_NONE:
+                if (c == '\e')
+                {
+                    ffStrbufClear(seq);
+                    ffStrbufAppendC(seq, c);
+                    parser->bare = false;
+                    parser->state = FF_TERMINAL_PARSE_STATE_ESC;
+                }
+                else if (c == '[' || c == ']')
+                {
+                    // Windows Terminal removes all `\e`s in its output
+                    ffStrbufSetS(seq, "\e");
+                    ffStrbufAppendC(seq, c);
+                    parser->bare = true;
+                    parser->state = c == '[' ? FF_TERMINAL_PARSE_STATE_CSI : FF_TERMINAL_PARSE_STATE_STRING;
+                }
+                break;
+            case FF_TERMINAL_PARSE_STATE_ESC:
+                ffStrbufAppendC(seq, c);
+                if (c == '[')
+                    parser->state = FF_TERMINAL_PARSE_STATE_CSI;
+                else if (c == ']' || c == 'P')
+                    parser->state = FF_TERMINAL_PARSE_STATE_STRING;
+                else
+                    parser->state = FF_TERMINAL_PARSE_STATE_NONE;
+                break;
+            case FF_TERMINAL_PARSE_STATE_CSI:
+                ffStrbufAppendC(seq, c);
+                complete = c >= 0x40 && c <= 0x7E;
+                break;
+            case FF_TERMINAL_PARSE_STATE_STRING:
+                if (c == '\a')
+                {
+                    ffStrbufAppendC(seq, c);
+                    complete = true;
+                }
+                else if (c == '\e')
+                {
+                    ffStrbufAppendC(seq, c);
+                    parser->state = FF_TERMINAL_PARSE_STATE_STRING_ESC;
+                }
+                else if (c == '\\' && parser->bare)
+                {
+                    // ST without its `\e`
+                    ffStrbufAppendS(seq, "\e\\");
+                    complete = true;
+                }
+                else
+                    ffStrbufAppendC(seq, c);
+                break;
+            case FF_TERMINAL_PARSE_STATE_STRING_ESC:
+                ffStrbufAppendC(seq, c);
+                if (c == '\\')
+                    complete = true;
+                else
+                    parser->state = FF_TERMINAL_PARSE_STATE_STRING;
+                break;
+        }
+
+        if (complete)
+        {
+            if (assignTerminalReply(seq, queries, count, &parser->current))
+                return true;
+            parser->state = FF_TERMINAL_PARSE_STATE_NONE;
+        }
+    }
+
+    return false;
+}
+
+const char* ffGetTerminalResponses(FFTerminalQuery* queries, uint32_t count)
+{
+    const char* error = openTerminal();
+    if (error) return error;
 
-    char buffer[1024];
-    size_t bytesRead = 0;
+    // DA1 is answered by virtually all terminals. Its reply comes after all other replies
+    FF_STRBUF_AUTO_DESTROY request = ffStrbufCreate();
+    for (uint32_t i = 0; i < count; ++i)
+        ffStrbufAppendS(&request, queries[i].request);
+    ffStrbufAppendS(&request, "\e[c");
+    ffWriteFDData(ftty, request.length, request.chars);
 
-    va_list args;
-    va_start(args, format);
+    FFTerminalReplyParser parser = { .seq = ffStrbufCreate() };
 
     while (true)
     {
-        ssize_t nRead = read(ftty, buffer + bytesRead, sizeof(buffer) - bytesRead - 1);
+        if (!waitTerminal())
+        {
+            ffStrbufDestroy(&parser.seq);
+
+            // The terminal may not support DA1
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                if (queries[i].response.length > 0)
+                    return NULL;
+            }
+            return "poll(/dev/tty) timeout or failed";
+        }
 
+        char buffer[1024];
+        ssize_t nRead = read(ftty, buffer, sizeof(buffer));
         if (nRead <= 0)
         {
-            va_end(args);
-            return "read(STDIN_FILENO, buffer, sizeof(buffer) - 1) failed";
+            ffStrbufDestroy(&parser.seq);
+            return "read(/dev/tty, buffer, sizeof(buffer)) failed";
         }
 
-        bytesRead += (size_t) nRead;
-        buffer[bytesRead] = '\0';
-
-        va_list cargs;
-        va_copy(cargs, args);
-        int ret = vsscanf(buffer, format, cargs);
-        va_end(cargs);
-
-        if (ret <= 0)
+        if (ffTerminalParseReplies(&parser, buffer, (uint32_t) nRead, queries, count))
         {
-            va_end(args);
-            return "vsscanf(buffer, format, args) failed";
+            ffStrbufDestroy(&parser.seq);
+            return NULL;
         }
-        if (ret >= nParams)
-            break;
     }
+}
+
+const char* ffGetTerminalResponse(const char* request, int nParams, const char* format, ...)
+{
+    FFTerminalQuery query = { .request = request, .response = ffStrbufCreate() };
+    const char* error = ffGetTerminalResponses(&query, 1);
+
+    if (!error)
+    {
+        va_list args;
+        va_start(args, format);
+        if (vsscanf(query.response.chars, format, args) < nParams)
+            error = "vsscanf(buffer, format, args) failed";
+        va_end(args);
+    }
+
+    ffStrbufDestroy(&query.response);
+    return error;
+}
+
+// `TERM\0` followed by `request\0response\0` pairs
+static FFstrbuf termCachePath;
+static FFstrbuf termCache;
+
+static bool loadTerminalCache(void)
+{
+    static bool loaded = false;
+    if (loaded)
+        return termCachePath.length > 0;
+    loaded = true;
+
+    ffStrbufInit(&termCachePath);
+    ffStrbufInit(&termCache);
+
+    const char* runtimeDir = getenv("XDG_RUNTIME_DIR");
+    if (!ffStrSet(runtimeDir))
+        return false;
+
+    struct stat st;
+    int fd = STDIN_FILENO;
+    while (fd <= STDERR_FILENO && !(isatty(fd) && fstat(fd, &st) == 0))
+        ++fd;
+    if (fd > STDERR_FILENO)
+        return false;
+
+    // Every new terminal window or SSH connection starts a new session on its tty
+    pid_t sid = getsid(0);
+    if (sid <= 0)
+        return false;
+
+    uint64_t startTime = 0;
+    #ifdef __linux__
+    {
+        // Guards against reused session ids
+        char path[32], buf[512];
+        snprintf(path, sizeof(path), "/proc/%d/stat", (int) sid);
+        ssize_t len = ffReadFileData(path, sizeof(buf) - 1, buf);
+        if (len <= 0)
+            return false;
+        buf[len] = '\0';
+
+        const char* p = strrchr(buf, ')');
+        if (!p || sscanf(p + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %*u %*u %*d %*d %*d %*d %*d %*d %" SCNu64, &startTime) != 1)
+            return false;
+    }
+    #endif
+
+    ffStrbufSetF(&termCachePath, "%s/fastfetch/terminal-%jx-%d-%" PRIu64, runtimeDir, (uintmax_t) st.st_rdev, (int) sid, startTime);
 
-    va_end(args);
+    const char* term = getenv("TERM");
+    if (!term) term = "";
+    size_t termLength = strlen(term) + 1;
 
+    if (!ffReadFileBuffer(termCachePath.chars, &termCache) ||
+        termCache.length < termLength || memcmp(termCache.chars, term, termLength) != 0)
+        ffStrbufSetNS(&termCache, (uint32_t) termLength, term);
+
+    return true;
+}
+
+static const char* findTerminalCache(const char* request)
+{
+    const char* end = termCache.chars + termCache.length;
+    const char* p = termCache.chars + strlen(termCache.chars) + 1;
+    while (p < end)
+    {
+        const char* response = p + strlen(p) + 1;
+        if (response >= end)
+            break;
+        if (ffStrEquals(p, request))
+            return response;
+        p = response + strlen(response) + 1;
+    }
     return NULL;
 }
 
+static void saveTerminalCache(const char* request, const FFstrbuf* response)
+{
+    ffStrbufAppendNS(&termCache, (uint32_t) strlen(request) + 1, request);
+    ffStrbufAppendNS(&termCache, response->length + 1, response->chars);
+
+    // Concurrent instances may write the same file
+    FF_STRBUF_AUTO_DESTROY tmpPath = ffStrbufCreateCopy(&termCachePath);
+    ffStrbufAppendF(&tmpPath, ".%d", (int) getpid());
+    if (ffWriteFileBuffer(tmpPath.chars, &termCache) && rename(tmpPath.chars, termCachePath.chars) == 0)
+        return;
+    unlink(tmpPath.chars);
+}
+
+const char* ffGetTerminalResponseCached(bool cacheOnly, const char* request, int nParams, const char* format, ...)
+{
+    bool cacheable = loadTerminalCache();
+    const char* cached = cacheable ? findTerminalCache(request) : NULL;
+
+    FFTerminalQuery query = { .request = request, .response = ffStrbufCreate() };
+    const char* error = NULL;
+
+    if (cached)
+        ffStrbufSetS(&query.response, cached);
+    else if (cacheOnly)
+        error = "Terminal response is not cached";
+    else if (!(error = ffGetTerminalResponses(&query, 1)) && cacheable)
+        saveTerminalCache(request, &query.response); // Empty responses are confirmed by DA1 and cached too
+
+    if (!error)
+    {
+        va_list args;
+        va_start(args, format);
+        if (vsscanf(query.response.chars, format, args) < nParams)
+            error = "vsscanf(buffer, format, args) failed";
+        va_end(args);
+    }
+
+    ffStrbufDestroy(&query.response);
+    return error;
+}
+
 bool ffSuppressIO(bool suppress)
 {
     static bool init = false;
@@ -250,7 +250,7 @@ void ffListFilesRecursively(const char* path, bool pretty)
     listFilesRecursively(folder.length, &folder, 0, NULL, pretty);
 }
 
-const char* ffGetTerminalResponse(const char* request, int nParams, const char* format, ...)
+static const char* getTerminalResponseV(const char* request, int nParams, const char* format, va_list args)
 {
     HANDLE hInput = GetStdHandle(STD_INPUT_HANDLE);
     FF_AUTO_CLOSE_FD HANDLE hConin = INVALID_HANDLE_VALUE;
@@ -301,9 +301,6 @@ const char* ffGetTerminalResponse(const char* request, int nParams, const char*
             ReadConsoleInputW(hInput, &record, 1, &len);
     }
 
-    va_list args;
-    va_start(args, format);
-
     char buffer[1024];
     uint32_t bytesRead = 0;
 
@@ -311,10 +308,7 @@ const char* ffGetTerminalResponse(const char* request, int nParams, const char*
     {
         DWORD bytes = 0;
         if (!ReadFile(hInput, buffer, sizeof(buffer) - 1, &bytes, NULL) || bytes == 0)
-        {
-            va_end(args);
             return "ReadFile() failed";
-        }
 
         bytesRead += bytes;
         buffer[bytesRead] = '\0';
@@ -325,17 +319,34 @@ const char* ffGetTerminalResponse(const char* request, int nParams, const char*
         va_end(cargs);
 
         if (ret <= 0)
-        {
-            va_end(args);
             return "vsscanf(buffer, format, args) failed";
-        }
         if (ret >= nParams)
             break;
     }
 
     SetConsoleMode(hInput, inputMode);
 
+    return NULL;
+}
+
+const char* ffGetTerminalResponse(const char* request, int nParams, const char* format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    const char* error = getTerminalResponseV(request, nParams, format, args);
     va_end(args);
+    return error;
+}
 
-    return NULL;
+const char* ffGetTerminalResponseCached(bool cacheOnly, const char* request, int nParams, const char* format, ...)
+{
+    // There is no per-session runtime directory on Windows
+    if (cacheOnly)
+        return "Terminal response cache is not supported on Windows";
+
+    va_list args;
+    va_start(args, format);
+    const char* error = getTerminalResponseV(request, nParams, format, args);
+    va_end(args);
+    return error;
 }
@@ -1,6 +1,7 @@
 #include "fastfetch.h"
 #include "common/color.h"
 #include "common/jsonconfig.h"
+#include "common/preload.h"
 #include "common/printing.h"
 #include "common/io/io.h"
 #include "common/time.h"
@@ -128,6 +129,9 @@ static bool parseModuleJsonObject(const char* type, yyjson_val* jsonVal, yyjson_
 static void prepareModuleJsonObject(const char* type, yyjson_val* module)
 {
     FFconfig* cfg = &instance.config;
+    if (cfg->general.multithreading)
+        ffPreloadModuleLibraries(type, (uint32_t) strlen(type));
+
     switch (type[0])
     {
         case 'b': case 'B': {
@@ -1,5 +1,7 @@
 #include "fastfetch.h"
 #include "common/library.h"
+#include "common/thread.h"
+#include "util/stringUtils.h"
 
 #ifndef FF_DISABLE_DLOPEN
 
@@ -20,9 +22,12 @@
     #endif
 #endif
 
-static void* libraryLoad(const char* path, int maxVersion)
+// `loadedPath` receives the path that was actually loaded, if not NULL
+static void* libraryLoad(const char* path, int maxVersion, FFstrbuf* loadedPath)
 {
     void* result = dlopen(path, FF_DLOPEN_FLAGS);
+    if (result != NULL && loadedPath)
+        ffStrbufSetS(loadedPath, path);
 
     #ifdef _WIN32
 
@@ -38,7 +43,10 @@ static void* libraryLoad(const char* path, int maxVersion)
 
     char absPath[MAX_PATH + 1];
     strcpy(mempcpy(absPath, instance.state.platform.exePath.chars, pathLen + 1), path);
-    return dlopen(absPath, FF_DLOPEN_FLAGS);
+    result = dlopen(absPath, FF_DLOPEN_FLAGS);
+    if (result != NULL && loadedPath)
+        ffStrbufSetS(loadedPath, absPath);
+    return result;
 
     #else
 
@@ -56,7 +64,11 @@ static void* libraryLoad(const char* path, int maxVersion)
 
         result = dlopen(pathbuf.chars, FF_DLOPEN_FLAGS);
         if(result != NULL)
+        {
+            if (loadedPath)
+                ffStrbufSet(loadedPath, &pathbuf);
             break;
+        }
 
         ffStrbufSubstrBefore(&pathbuf, originalLength);
     }
@@ -66,9 +78,144 @@ static void* libraryLoad(const char* path, int maxVersion)
     return result;
 }
 
+#ifdef FF_HAVE_THREADS
+
+typedef struct FFLibraryPreload
+{
+    const char* paths[4];
+    int maxVersions[4];
+    FFstrbuf loadedPath; // Empty if all paths failed
+    bool done;
+} FFLibraryPreload;
+
+// Filled by the main thread, consumed in order by one worker thread
+static FFLibraryPreload preloads[16];
+static uint32_t preloadCount;
+static uint32_t preloadNext;
+static bool preloadRunning;
+static FFThreadMutex preloadMutex = FF_THREAD_MUTEX_INITIALIZER;
+
+static void preloadLibraries(void)
+{
+    while (true)
+    {
+        ffThreadMutexLock(&preloadMutex);
+        if (preloadNext == preloadCount)
+        {
+            preloadRunning = false;
+            ffThreadMutexUnlock(&preloadMutex);
+            return;
+        }
+        FFLibraryPreload* preload = &preloads[preloadNext++];
+        ffThreadMutexUnlock(&preloadMutex);
+
+        // The handle is leaked on purpose to keep the library resident
+        FF_STRBUF_AUTO_DESTROY loadedPath = ffStrbufCreate();
+        for (uint32_t i = 0; i < ARRAY_SIZE(preload->paths) && preload->paths[i]; ++i)
+        {
+            if (libraryLoad(preload->paths[i], preload->maxVersions[i], &loadedPath))
+                break;
+        }
+
+        ffThreadMutexLock(&preloadMutex);
+        ffStrbufInitMove(&preload->loadedPath, &loadedPath);
+        preload->done = true;
+        ffThreadMutexUnlock(&preloadMutex);
+    }
+}
+
+FF_THREAD_ENTRY_DECL_WRAPPER_NOPARAM(preloadLibraries)
+
+void ffLibraryPreload(const char* path, int maxVersion, ...)
+{
+    if (!instance.config.general.multithreading)
+        return;
+
+    ffThreadMutexLock(&preloadMutex);
+
+    for (uint32_t i = 0; i < preloadCount; ++i)
+    {
+        if (ffStrEquals(preloads[i].paths[0], path))
+        {
+            ffThreadMutexUnlock(&preloadMutex);
+            return;
+        }
+    }
+    if (preloadCount == ARRAY_SIZE(preloads))
+    {
+        ffThreadMutexUnlock(&preloadMutex);
+        return;
+    }
+
+    FFLibraryPreload* preload = &preloads[preloadCount++];
+    *preload = (FFLibraryPreload) {
+        .paths = { path },
+        .maxVersions = { maxVersion },
+    };
+
+    va_list defaultNames;
+    va_start(defaultNames, maxVersion);
+    for (uint32_t i = 1; i < ARRAY_SIZE(preload->paths); ++i)
+    {
+        const char* pathRest = va_arg(defaultNames, const char*);
+        if (pathRest == NULL)
+            break;
+        preload->paths[i] = pathRest;
+        preload->maxVersions[i] = va_arg(defaultNames, int);
+    }
+    va_end(defaultNames);
+
+    bool start = !preloadRunning;
+    preloadRunning = true;
+    ffThreadMutexUnlock(&preloadMutex);
+
+    if (start)
+    {
+        FFThreadType thread = ffThreadCreate(preloadLibrariesThreadMain, NULL);
+        if (thread)
+            ffThreadDetach(thread);
+        else
+        {
+            // Pending entries are never marked as done; ffLibraryLoad() loads them as usual
+            ffThreadMutexLock(&preloadMutex);
+            preloadRunning = false;
+            ffThreadMutexUnlock(&preloadMutex);
+        }
+    }
+}
+
+static void* loadPreloaded(const char* path)
+{
+    const char* loadedPath = NULL;
+
+    ffThreadMutexLock(&preloadMutex);
+    for (uint32_t i = 0; i < preloadCount; ++i)
+    {
+        if (preloads[i].done && preloads[i].loadedPath.length > 0 && ffStrEquals(preloads[i].paths[0], path))
+        {
+            loadedPath = preloads[i].loadedPath.chars; // Never modified once done
+            break;
+        }
+    }
+    ffThreadMutexUnlock(&preloadMutex);
+
+    // Cheap because the library is resident. Skips probing the names that don't exist
+    return loadedPath ? dlopen(loadedPath, FF_DLOPEN_FLAGS) : NULL;
+}
+
+#else
+
+void ffLibraryPreload(FF_MAYBE_UNUSED const char* path, FF_MAYBE_UNUSED int maxVersion, ...) {}
+
+static inline void* loadPreloaded(FF_MAYBE_UNUSED const char* path) { return NULL; }
+
+#endif
+
 void* ffLibraryLoad(const char* path, int maxVersion, ...)
 {
-    void* result = libraryLoad(path, maxVersion);
+    void* result = loadPreloaded(path);
+    if (!result)
+        result = libraryLoad(path, maxVersion, NULL);
 
     if (!result)
     {
@@ -82,7 +229,7 @@ void* ffLibraryLoad(const char* path, int maxVersion, ...)
                 break;
 
             int maxVersionRest = va_arg(defaultNames, int);
-            result = libraryLoad(pathRest, maxVersionRest);
+            result = libraryLoad(pathRest, maxVersionRest, NULL);
         } while (!result);
 
         va_end(defaultNames);
@@ -63,6 +63,10 @@ static inline void ffLibraryUnload(void** handle)
 
 void* ffLibraryLoad(const char* path, int maxVersion, ...);
 
+// Loads the library in a background thread, so that a later ffLibraryLoad() with the same first path finds it resident.
+// Takes the same arguments as ffLibraryLoad(). The library is never unloaded. Does nothing if multithreading is disabled
+void ffLibraryPreload(const char* path, int maxVersion, ...);
+
 #else
 
 #define FF_LIBRARY_EXTENSION ""
@@ -94,4 +98,6 @@ void* ffLibraryLoad(const char* path, int maxVersion, ...);
 #define FF_LIBRARY_LOAD_SYMBOL_PTR(library, varName, symbolName, returnValue) \
     FF_LIBRARY_LOAD_SYMBOL_ADDRESS(library, (varName)->ff ## symbolName, symbolName, returnValue);
 
+static inline void ffLibraryPreload(FF_MAYBE_UNUSED const char* path, FF_MAYBE_UNUSED int maxVersion, ...) {}
+
 #endif
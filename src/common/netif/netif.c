@@ -1,7 +1,11 @@
 #include "netif.h"
+#include "util/stringUtils.h"
 
 #ifndef _WIN32
     #include <net/if.h>
+    #include <ifaddrs.h>
+    #include <netinet/in.h>
+    #include <arpa/inet.h>
 #else
     #define IF_NAMESIZE 0
 #endif
@@ -23,6 +27,37 @@ const char* ffNetifGetDefaultRouteIfName()
     return ifName;
 }
 
+#ifndef _WIN32
+bool ffNetifAppendDefaultRouteIfAddresses(FFstrbuf* result)
+{
+    const char* name = ffNetifGetDefaultRouteIfName();
+    if (!name[0]) return false;
+
+    struct ifaddrs* ifAddrStruct = NULL;
+    if (getifaddrs(&ifAddrStruct) < 0) return false;
+
+    for (struct ifaddrs* ifa = ifAddrStruct; ifa; ifa = ifa->ifa_next)
+    {
+        if (!ifa->ifa_addr || !ffStrEquals(ifa->ifa_name, name))
+            continue;
+
+        char addr[INET6_ADDRSTRLEN];
+        if (ifa->ifa_addr->sa_family == AF_INET)
+            inet_ntop(AF_INET, &((struct sockaddr_in*) ifa->ifa_addr)->sin_addr, addr, sizeof(addr));
+        else if (ifa->ifa_addr->sa_family == AF_INET6)
+            inet_ntop(AF_INET6, &((struct sockaddr_in6*) ifa->ifa_addr)->sin6_addr, addr, sizeof(addr));
+        else
+            continue;
+
+        ffStrbufAppendC(result, ' ');
+        ffStrbufAppendS(result, addr);
+    }
+
+    freeifaddrs(ifAddrStruct);
+    return true;
+}
+#endif
+
 uint32_t ffNetifGetDefaultRouteIfIndex()
 {
     init();
@@ -4,6 +4,15 @@
 
 #ifndef _WIN32
 const char* ffNetifGetDefaultRouteIfName();
+// Appends the addresses assigned to the default route interface, as a fingerprint of the current network
+bool ffNetifAppendDefaultRouteIfAddresses(FFstrbuf* result);
 #endif
 
 uint32_t ffNetifGetDefaultRouteIfIndex();
+
+#ifdef __linux__
+// Sends a netlink request and collects all reply messages (until NLMSG_DONE for dumps) into `reply`
+bool ffNetlinkRequest(int sock, const void* request, FFstrbuf* reply);
+// Resolves the id of a generic netlink family such as "nl80211" or "ethtool". Returns 0 on failure
+uint16_t ffNetlinkGetGenlFamily(int sock, const char* name);
+#endif
@@ -3,12 +3,200 @@
 
 #include <net/if.h>
 #include <stdio.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <linux/genetlink.h>
+
+#pragma GCC diagnostic ignored "-Wsign-conversion" // NLMSG_NEXT / RTA_NEXT
 
 #define FF_STR_INDIR(x) #x
 #define FF_STR(x) FF_STR_INDIR(x)
 
+// Large enough for one dump batch; the kernel sizes dump batches after the biggest receive buffer it has seen
+#define FF_NETLINK_RECV_SIZE 32768
+
+bool ffNetlinkRequest(int sock, const void* request, FFstrbuf* reply)
+{
+    const struct nlmsghdr* req = (const struct nlmsghdr*) request;
+    struct sockaddr_nl nladdr = { .nl_family = AF_NETLINK };
+    if (sendto(sock, request, req->nlmsg_len, 0, (struct sockaddr*) &nladdr, sizeof(nladdr)) < 0)
+        return false;
+
+    ffStrbufClear(reply);
+
+    while (true)
+    {
+        ffStrbufEnsureFree(reply, FF_NETLINK_RECV_SIZE);
+        ssize_t len = recv(sock, reply->chars + reply->length, FF_NETLINK_RECV_SIZE, MSG_TRUNC);
+        if (len <= 0 || len > FF_NETLINK_RECV_SIZE)
+            return false;
+
+        bool done = false;
+        int remaining = (int) len;
+        for (struct nlmsghdr* nlh = (struct nlmsghdr*) (reply->chars + reply->length); NLMSG_OK(nlh, remaining); nlh = NLMSG_NEXT(nlh, remaining))
+        {
+            if (nlh->nlmsg_seq != req->nlmsg_seq)
+                continue;
+
+            if (nlh->nlmsg_type == NLMSG_ERROR)
+            {
+                // error == 0 is an ACK
+                if (((struct nlmsgerr*) NLMSG_DATA(nlh))->error != 0)
+                    return false;
+                done = true;
+            }
+            else if (nlh->nlmsg_type == NLMSG_DONE || !(nlh->nlmsg_flags & NLM_F_MULTI))
+                done = true;
+        }
+
+        reply->length += (uint32_t) len;
+        reply->chars[reply->length] = '\0';
+
+        if (done)
+            return true;
+    }
+}
+
+uint16_t ffNetlinkGetGenlFamily(int sock, const char* name)
+{
+    struct {
+        struct nlmsghdr nlh;
+        struct genlmsghdr genl;
+        struct rtattr rta;
+        char name[GENL_NAMSIZ];
+    } req = {
+        .nlh = {
+            .nlmsg_type = GENL_ID_CTRL,
+            .nlmsg_flags = NLM_F_REQUEST,
+            .nlmsg_seq = 1,
+        },
+        .genl = {
+            .cmd = CTRL_CMD_GETFAMILY,
+            .version = 1,
+        },
+        .rta = {
+            .rta_type = CTRL_ATTR_FAMILY_NAME,
+        },
+    };
+    size_t nameLen = strlen(name) + 1;
+    if (nameLen > GENL_NAMSIZ) return 0;
+    memcpy(req.name, name, nameLen);
+    req.rta.rta_len = (unsigned short) RTA_LENGTH(nameLen);
+    req.nlh.nlmsg_len = NLMSG_LENGTH(GENL_HDRLEN) + RTA_ALIGN(req.rta.rta_len);
+
+    FF_STRBUF_AUTO_DESTROY reply = ffStrbufCreate();
+    if (!ffNetlinkRequest(sock, &req, &reply))
+        return 0;
+
+    int remaining = (int) reply.length;
+    for (struct nlmsghdr* nlh = (struct nlmsghdr*) reply.chars; NLMSG_OK(nlh, remaining); nlh = NLMSG_NEXT(nlh, remaining))
+    {
+        if (nlh->nlmsg_type != GENL_ID_CTRL)
+            continue;
+
+        int attrLen = (int) NLMSG_PAYLOAD(nlh, GENL_HDRLEN);
+        for (struct rtattr* rta = (struct rtattr*) ((uint8_t*) NLMSG_DATA(nlh) + GENL_HDRLEN); RTA_OK(rta, attrLen); rta = RTA_NEXT(rta, attrLen))
+        {
+            if (rta->rta_type == CTRL_ATTR_FAMILY_ID)
+                return *(uint16_t*) RTA_DATA(rta);
+        }
+    }
+    return 0;
+}
+
+static bool getDefaultRouteNetlink(char iface[IF_NAMESIZE + 1], uint32_t* ifIndex)
+{
+    FF_AUTO_CLOSE_FD int sock = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+    if (sock < 0)
+        return false;
+
+    struct {
+        struct nlmsghdr nlh;
+        struct rtmsg rtm;
+    } req = {
+        .nlh = {
+            .nlmsg_len = NLMSG_LENGTH(sizeof(struct rtmsg)),
+            .nlmsg_type = RTM_GETROUTE,
+            .nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP,
+            .nlmsg_seq = 1,
+        },
+        .rtm = {
+            .rtm_family = AF_UNSPEC, // Both IPv4 and IPv6
+        },
+    };
+
+    FF_STRBUF_AUTO_DESTROY reply = ffStrbufCreate();
+    if (!ffNetlinkRequest(sock, &req, &reply))
+        return false;
+
+    // Prefer IPv4 default routes; among the same family, prefer the lowest metric
+    uint32_t bestIndex = 0, bestPriority = UINT32_MAX;
+    uint8_t bestFamily = AF_UNSPEC;
+
+    int remaining = (int) reply.length;
+    for (struct nlmsghdr* nlh = (struct nlmsghdr*) reply.chars; NLMSG_OK(nlh, remaining); nlh = NLMSG_NEXT(nlh, remaining))
+    {
+        if (nlh->nlmsg_type != RTM_NEWROUTE)
+            continue;
+
+        struct rtmsg* rtm = (struct rtmsg*) NLMSG_DATA(nlh);
+        if (rtm->rtm_dst_len != 0 || rtm->rtm_type != RTN_UNICAST || (rtm->rtm_family != AF_INET && rtm->rtm_family != AF_INET6))
+            continue;
+
+        uint32_t table = rtm->rtm_table, oif = 0, priority = 0;
+        int attrLen = (int) RTM_PAYLOAD(nlh);
+        for (struct rtattr* rta = RTM_RTA(rtm); RTA_OK(rta, attrLen); rta = RTA_NEXT(rta, attrLen))
+        {
+            switch (rta->rta_type)
+            {
+            case RTA_TABLE:
+                table = *(uint32_t*) RTA_DATA(rta);
+                break;
+            case RTA_OIF:
+                oif = *(uint32_t*) RTA_DATA(rta);
+                break;
+            case RTA_PRIORITY:
+                priority = *(uint32_t*) RTA_DATA(rta);
+                break;
+            case RTA_MULTIPATH:
+                if (oif == 0 && RTA_PAYLOAD(rta) >= sizeof(struct rtnexthop))
+                    oif = (uint32_t) ((struct rtnexthop*) RTA_DATA(rta))->rtnh_ifindex;
+                break;
+            }
+        }
+
+        if (table != RT_TABLE_MAIN || oif == 0)
+            continue;
+
+        if (bestFamily == AF_UNSPEC ||
+            (rtm->rtm_family == AF_INET && bestFamily == AF_INET6) ||
+            (rtm->rtm_family == bestFamily && priority < bestPriority))
+        {
+            bestIndex = oif;
+            bestPriority = priority;
+            bestFamily = rtm->rtm_family;
+        }
+    }
+
+    if (bestIndex == 0)
+    {
+        iface[0] = '\0';
+        *ifIndex = 0;
+        return true; // No default route at all is still a valid answer
+    }
+
+    if (!if_indextoname(bestIndex, iface))
+        return false;
+    *ifIndex = bestIndex;
+    return true;
+}
+
 bool ffNetifGetDefaultRouteImpl(char iface[IF_NAMESIZE + 1], uint32_t* ifIndex)
 {
+    if (getDefaultRouteNetlink(iface, ifIndex))
+        return *ifIndex != 0;
+
     FILE* FF_AUTO_CLOSE_FILE netRoute = fopen("/proc/net/route", "r");
     if (!netRoute) return false;
 
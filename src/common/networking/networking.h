@@ -9,30 +9,88 @@
 
 struct addrinfo;
 
+typedef enum FFHttpParserPhase
+{
+    FF_HTTP_PHASE_STATUS_LINE,
+    FF_HTTP_PHASE_HEADER,
+    FF_HTTP_PHASE_BODY, // Content-Length
+    FF_HTTP_PHASE_BODY_UNTIL_EOF, // Neither Content-Length nor chunked
+    FF_HTTP_PHASE_CHUNK_SIZE,
+    FF_HTTP_PHASE_CHUNK_DATA,
+    FF_HTTP_PHASE_CHUNK_DATA_END,
+    FF_HTTP_PHASE_TRAILER,
+    FF_HTTP_PHASE_DONE,
+} FFHttpParserPhase;
+
+// Incremental HTTP/1.1 response parser. Received bytes are fed as they arrive;
+// the decoded (de-chunked and decompressed) body is collected in `body`
+typedef struct FFHttpParser
+{
+    FFstrbuf line; // Partial status / header / chunk size line
+    FFstrbuf body;
+    struct FFGzipStream* gzipStream;
+    uint32_t remaining; // Bytes left of the body (Content-Length) or of the current chunk
+    uint16_t statusCode;
+    FFHttpParserPhase phase;
+    bool allowGzip;
+    bool hasContentLength;
+    bool chunked;
+    bool gzip;
+} FFHttpParser;
+
+void ffHttpParserInit(FFHttpParser* parser, bool allowGzip);
+// Returns an error message if the data is invalid
+const char* ffHttpParserFeed(FFHttpParser* parser, const char* data, uint32_t length);
+static inline bool ffHttpParserIsDone(const FFHttpParser* parser) { return parser->phase == FF_HTTP_PHASE_DONE; }
+// Must be called when the connection is closed or the response is done. Returns an error message if the response is incomplete or not 200 OK
+const char* ffHttpParserFinish(FFHttpParser* parser);
+void ffHttpParserDestroy(FFHttpParser* parser);
+
 typedef struct FFNetworkingState {
     #ifdef _WIN32
         uintptr_t sockfd;
         OVERLAPPED overlapped;
     #else
         int sockfd;
+        int sockfdAlt; // The concurrent connection attempt to the next address (Happy Eyeballs)
+        FFstrbuf host;
         FFstrbuf command;
+        uint32_t commandSent;
         struct addrinfo* addr;
+        bool addrFromCache; // `addr` was loaded from the DNS cache and must be freed with free()
+        struct addrinfo* nextAddr; // The next address to try
+        struct FFResolveJob* resolveJob; // Pending background resolve, started when all cached addresses failed
+        uint64_t nextAttemptTime;
+        uint64_t deadline;
 
-        #ifdef FF_HAVE_THREADS
-            FFThreadType thread;
-        #endif
+        FFHttpParser parser;
+        const char* error;
+        bool connected;
+        bool done;
     #endif
 
     uint32_t timeout;
     bool ipv6;
+    bool dualStack; // if true, both IPv4 and IPv6 addresses are raced (Happy Eyeballs) and `ipv6` is ignored. Not supported on Windows
     bool compression; // if true, HTTP content compression will be enabled if supported
     bool tfo; // if true, TCP Fast Open will be attempted first, and fallback to traditional connection if it fails
 } FFNetworkingState;
 
 const char* ffNetworkingSendHttpRequest(FFNetworkingState* state, const char* host, const char* path, const char* headers);
-const char* ffNetworkingRecvHttpResponse(FFNetworkingState* state, FFstrbuf* buffer);
+// Stores the decoded response body (without HTTP header) in `body`
+const char* ffNetworkingRecvHttpResponse(FFNetworkingState* state, FFstrbuf* body);
+
+// Response cache stored in `cacheDir/fastfetch/http/`. `key` must identify the request (host, path, etc)
+// Returns true if a response for `key` not older than `ttl` seconds exists and stores it in `body`
+bool ffNetworkingCacheRead(const char* key, uint32_t ttl, FFstrbuf* body);
+void ffNetworkingCacheWrite(const char* key, const FFstrbuf* body);
 
 #ifdef FF_HAVE_ZLIB
 const char* ffNetworkingLoadZlibLibrary(void);
-bool ffNetworkingDecompressGzip(FFstrbuf* buffer, char* headerEnd);
+
+typedef struct FFGzipStream FFGzipStream;
+FFGzipStream* ffNetworkingGzipStreamCreate(void);
+// Inflates the next chunk of gzip data and appends the output to `result`. Returns false if the data is corrupted
+bool ffNetworkingGzipStreamInflate(FFGzipStream* stream, const void* data, uint32_t length, FFstrbuf* result);
+void ffNetworkingGzipStreamDestroy(FFGzipStream* stream);
 #endif
@@ -1,9 +1,13 @@
 #include "fastfetch.h"
 #include "common/library.h"
 #include "common/networking/networking.h"
+#include "common/io/io.h"
+#include "common/time.h"
 #include "util/stringUtils.h"
 #include "util/debug.h"
 
+#include <inttypes.h>
+
 #ifdef FF_HAVE_ZLIB
 #include <zlib.h>
 
@@ -38,157 +42,338 @@ const char* ffNetworkingLoadZlibLibrary(void)
     return zlibData.ffinflateEnd == NULL ? "Failed to load libz" : NULL;
 }
 
-// Try to pre-read gzip header to determine uncompressed size
-static uint32_t guessGzipOutputSize(const void* data, uint32_t dataSize)
+struct FFGzipStream
 {
-    // gzip file format: http://www.zlib.org/rfc-gzip.html
-    if (dataSize < 10 || ((const uint8_t*)data)[0] != 0x1f || ((const uint8_t*)data)[1] != 0x8b)
-        return 0;
+    z_stream zs;
+    bool finished;
+};
 
-    // Uncompressed size in gzip format is stored in the last 4 bytes, but only valid if data is less than 4GB
-    if (dataSize > 18) {
-        // Get ISIZE value from the end of file (little endian)
-        const uint8_t* tail = (const uint8_t*)data + dataSize - 4;
-        uint32_t uncompressedSize = (uint32_t) tail[0] | ((uint32_t) tail[1] << 8u) | ((uint32_t) tail[2] << 16u) | ((uint32_t) tail[3] << 24u);
+FFGzipStream* ffNetworkingGzipStreamCreate(void)
+{
+    if (ffNetworkingLoadZlibLibrary() != NULL)
+        return NULL;
 
-        // For valid gzip files, this value is the length of the uncompressed data modulo 2^32
-        if (uncompressedSize > 0) {
-            FF_DEBUG("Read uncompressed size from GZIP trailer: %u bytes", uncompressedSize);
-            // Add some margin to the estimated size for safety
-            return uncompressedSize + 64;
-        }
+    FFGzipStream* stream = calloc(1, sizeof(*stream));
+    // 16 + MAX_WBITS: expect gzip header and trailer
+    if (zlibData.ffinflateInit2_(&stream->zs, 16 + MAX_WBITS, ZLIB_VERSION, (int)sizeof(z_stream)) != Z_OK)
+    {
+        FF_DEBUG("Failed to initialize decompression engine");
+        free(stream);
+        return NULL;
     }
-
-    // If unable to get size from trailer or size is 0, use estimated value
-    // Typically, text data compression ratio is between 3-5x, we use the larger value
-    uint32_t estimatedSize = dataSize * 5;
-    FF_DEBUG("Unable to read exact uncompressed size, estimated as 5x of compressed data: %u bytes", estimatedSize);
-    return estimatedSize;
+    return stream;
 }
 
-// Decompress gzip content
-bool ffNetworkingDecompressGzip(FFstrbuf* buffer, char* headerEnd)
+bool ffNetworkingGzipStreamInflate(FFGzipStream* stream, const void* data, uint32_t length, FFstrbuf* result)
 {
-    // Calculate header size
-    uint32_t headerSize = (uint32_t) (headerEnd - buffer->chars);
+    if (stream->finished)
+        return true; // Ignore trailing garbage
 
-    *headerEnd = '\0'; // Replace delimiter with null character for easier processing
-    // Ensure Content-Encoding is in response headers, not in response body
-    bool hasGzip = strcasestr(buffer->chars, "\nContent-Encoding: gzip") != NULL;
-    *headerEnd = '\r'; // Restore delimiter
+    stream->zs.next_in = (Bytef*) data;
+    stream->zs.avail_in = (uInt) length;
 
-    if (!hasGzip) {
-        FF_DEBUG("No gzip compressed content detected, skipping decompression");
-        return true;
-    }
-
-    FF_DEBUG("Gzip compressed content detected, preparing for decompression");
-
-    const char* bodyStart = headerEnd + 4; // Skip delimiter
+    while (true)
+    {
+        // Text compresses 3-5x typically
+        ffStrbufEnsureFree(result, length * 4 > 4096 ? length * 4 : 4096);
+        stream->zs.next_out = (Bytef*) (result->chars + result->length);
+        stream->zs.avail_out = (uInt) ffStrbufGetFree(result);
+        uInt availableOut = stream->zs.avail_out;
 
-    // Calculate compressed content size
-    uint32_t compressedSize = buffer->length - headerSize - 4;
+        int ret = zlibData.ffinflate(&stream->zs, Z_NO_FLUSH);
+        result->length += (uint32_t) (availableOut - stream->zs.avail_out);
+        result->chars[result->length] = '\0';
 
-    if (compressedSize <= 0) {
-        // No content to decompress
-        FF_DEBUG("Compressed content size is 0, skipping decompression");
-        return true;
+        if (ret == Z_STREAM_END)
+        {
+            FF_DEBUG("Gzip stream finished, total output: %lu bytes", (unsigned long) stream->zs.total_out);
+            stream->finished = true;
+            return true;
+        }
+        if (ret != Z_OK && ret != Z_BUF_ERROR)
+        {
+            FF_DEBUG("inflate() failed: %d", ret);
+            return false;
+        }
+        if (stream->zs.avail_in == 0 && stream->zs.avail_out > 0)
+            return true; // Need more input
     }
+}
 
-    // Check if content is actually in gzip format (gzip header magic is 0x1f 0x8b)
-    if (compressedSize < 2 || (uint8_t)bodyStart[0] != 0x1f || (uint8_t)bodyStart[1] != 0x8b) {
-        FF_DEBUG("Content is not valid gzip format, skipping decompression");
-        return false;
-    }
+void ffNetworkingGzipStreamDestroy(FFGzipStream* stream)
+{
+    if (!stream) return;
+    zlibData.ffinflateEnd(&stream->zs);
+    free(stream);
+}
+#endif // FF_HAVE_ZLIB
+
+// Longest status / header / chunk size line we accept
+#define FF_HTTP_MAX_LINE_LENGTH 8192
+// Largest Content-Length / chunk size we accept. Responses of the modules are a few KiB
+#define FF_HTTP_MAX_BODY_LENGTH (16 * 1024 * 1024)
+// Reserved up front for a body with Content-Length; larger ones grow as data arrives
+#define FF_HTTP_BODY_RESERVE 65536
 
-    // Predict uncompressed size
-    uint32_t estimatedSize = guessGzipOutputSize(bodyStart, compressedSize);
-
-    // Create decompression buffer with estimated size
-    FF_STRBUF_AUTO_DESTROY decompressedBuffer = ffStrbufCreateA(estimatedSize > 0 ? estimatedSize : compressedSize * 5);
-    FF_DEBUG("Created decompression buffer: %u bytes", decompressedBuffer.allocated);
-
-    // Initialize decompression
-    z_stream zs = {
-        .zalloc = Z_NULL,
-        .zfree = Z_NULL,
-        .opaque = Z_NULL,
-        .avail_in = (uInt)compressedSize,
-        .next_in = (Bytef*)bodyStart,
-        .avail_out = (uInt)ffStrbufGetFree(&decompressedBuffer),
-        .next_out = (Bytef*)decompressedBuffer.chars,
+void ffHttpParserInit(FFHttpParser* parser, bool allowGzip)
+{
+    *parser = (FFHttpParser) {
+        .phase = FF_HTTP_PHASE_STATUS_LINE,
+        .allowGzip = allowGzip,
     };
+    ffStrbufInit(&parser->line);
+    ffStrbufInit(&parser->body);
+}
 
-    // Initialize decompression engine
-    if (zlibData.ffinflateInit2_(&zs, 16 + MAX_WBITS, ZLIB_VERSION, (int)sizeof(z_stream)) != Z_OK) {
-        FF_DEBUG("Failed to initialize decompression engine");
-        return false;
+void ffHttpParserDestroy(FFHttpParser* parser)
+{
+    ffStrbufDestroy(&parser->line);
+    ffStrbufDestroy(&parser->body);
+    #ifdef FF_HAVE_ZLIB
+    ffNetworkingGzipStreamDestroy(parser->gzipStream);
+    parser->gzipStream = NULL;
+    #endif
+}
+
+static const char* emitBody(FFHttpParser* parser, const char* data, uint32_t length)
+{
+    #ifdef FF_HAVE_ZLIB
+    if (parser->gzipStream)
+    {
+        if (!ffNetworkingGzipStreamInflate(parser->gzipStream, data, length, &parser->body))
+            return "Failed to decompress or invalid format";
+        return NULL;
     }
-    uInt availableOut = zs.avail_out;
+    #endif
+    ffStrbufAppendNS(&parser->body, length, data);
+    return NULL;
+}
 
-    // Perform decompression
-    int result = zlibData.ffinflate(&zs, Z_FINISH);
+static const char* parseHeaderLine(FFHttpParser* parser)
+{
+    const char* line = parser->line.chars;
 
-    // If output buffer is insufficient, try to extend buffer
-    while (result == Z_BUF_ERROR || (result != Z_STREAM_END && zs.avail_out == 0))
+    if (parser->phase == FF_HTTP_PHASE_STATUS_LINE)
     {
-        FF_DEBUG("Output buffer insufficient, trying to extend");
-
-        // Save already decompressed data amount
-        uint32_t alreadyDecompressed = (uint32_t)(availableOut - zs.avail_out);
-        decompressedBuffer.length += alreadyDecompressed;
-        decompressedBuffer.chars[decompressedBuffer.length] = '\0'; // Ensure null-terminated string
+        // HTTP/1.1 200 OK
+        if (parser->line.length < strlen("HTTP/1.1 200") || !ffStrStartsWith(line, "HTTP/1.") || line[8] != ' ')
+            return "Invalid response";
+        parser->statusCode = (uint16_t) strtoul(line + 9, NULL, 10);
+        FF_DEBUG("HTTP status: %u", parser->statusCode);
+        parser->phase = FF_HTTP_PHASE_HEADER;
+        return NULL;
+    }
 
-        ffStrbufEnsureFree(&decompressedBuffer, decompressedBuffer.length / 2);
+    if (*line == '\0')
+    {
+        // End of header
+        if (parser->statusCode >= 100 && parser->statusCode < 200)
+        {
+            // Interim response (100 Continue); the final one follows
+            parser->phase = FF_HTTP_PHASE_STATUS_LINE;
+            return NULL;
+        }
 
-        // Set output parameters to point to new buffer
-        zs.avail_out = (uInt)ffStrbufGetFree(&decompressedBuffer);
-        zs.next_out = (Bytef*)(decompressedBuffer.chars + decompressedBuffer.length);
-        availableOut = zs.avail_out;
+        if (parser->gzip)
+        {
+            #ifdef FF_HAVE_ZLIB
+            if (parser->allowGzip)
+                parser->gzipStream = ffNetworkingGzipStreamCreate();
+            #endif
+            if (!parser->gzipStream)
+                return "Failed to initialize gzip decompression";
+        }
 
-        // Decompress again
-        result = zlibData.ffinflate(&zs, Z_FINISH);
+        if (parser->chunked)
+            parser->phase = FF_HTTP_PHASE_CHUNK_SIZE;
+        else if (parser->hasContentLength)
+        {
+            ffStrbufEnsureFree(&parser->body, parser->remaining < FF_HTTP_BODY_RESERVE ? parser->remaining : FF_HTTP_BODY_RESERVE);
+            parser->phase = parser->remaining > 0 ? FF_HTTP_PHASE_BODY : FF_HTTP_PHASE_DONE;
+        }
+        else
+            parser->phase = FF_HTTP_PHASE_BODY_UNTIL_EOF;
+        return NULL;
     }
 
-    zlibData.ffinflateEnd(&zs);
+    const char* colon = strchr(line, ':');
+    if (!colon)
+        return "Invalid HTTP header";
+    uint32_t nameLength = (uint32_t) (colon - line);
+    const char* value = colon + 1;
+    while (*value == ' ' || *value == '\t') ++value;
 
-    // Calculate decompressed size
-    uint32_t decompressedSize = (uint32_t)(availableOut - zs.avail_out);
-    decompressedBuffer.length += decompressedSize;
-    decompressedBuffer.chars[decompressedSize] = '\0'; // Ensure null-terminated string
-    FF_DEBUG("Successfully decompressed %u bytes compressed data to %u bytes", compressedSize, decompressedBuffer.length);
+    #define FF_HEADER_IS(name) (nameLength == strlen(name) && strncasecmp(line, name, nameLength) == 0)
+    if (FF_HEADER_IS("Content-Length"))
+    {
+        char* end;
+        unsigned long long length = strtoull(value, &end, 10);
+        if (end == value || *value == '-' || length > FF_HTTP_MAX_BODY_LENGTH)
+            return "Invalid Content-Length";
+        parser->hasContentLength = true;
+        parser->remaining = (uint32_t) length;
+        FF_DEBUG("Detected Content-Length: %u", parser->remaining);
+    }
+    else if (FF_HEADER_IS("Transfer-Encoding"))
+        parser->chunked = strcasestr(value, "chunked") != NULL;
+    else if (FF_HEADER_IS("Content-Encoding"))
+        parser->gzip = strcasestr(value, "gzip") != NULL;
+    #undef FF_HEADER_IS
 
-    // Modify Content-Length header and remove Content-Encoding header
-    FF_STRBUF_AUTO_DESTROY newBuffer = ffStrbufCreateA(headerSize + decompressedSize + 64);
+    return NULL;
+}
 
-    char* line = NULL;
-    size_t len = 0;
-    while (ffStrbufGetline(&line, &len, buffer))
+static const char* parseChunkLine(FFHttpParser* parser)
+{
+    switch (parser->phase)
     {
-        if (ffStrStartsWithIgnCase(line, "Content-Encoding:"))
-        {
-            continue;
+        case FF_HTTP_PHASE_CHUNK_SIZE: {
+            char* end;
+            unsigned long long size = strtoull(parser->line.chars, &end, 16); // Chunk extensions are ignored
+            if (end == parser->line.chars || parser->line.chars[0] == '-' || size > FF_HTTP_MAX_BODY_LENGTH)
+                return "Invalid chunk size";
+            parser->remaining = (uint32_t) size;
+            parser->phase = parser->remaining > 0 ? FF_HTTP_PHASE_CHUNK_DATA : FF_HTTP_PHASE_TRAILER;
+            return NULL;
         }
-        else if (ffStrStartsWithIgnCase(line, "Content-Length:"))
+        case FF_HTTP_PHASE_CHUNK_DATA_END:
+            if (parser->line.length != 0)
+                return "Invalid chunk terminator";
+            parser->phase = FF_HTTP_PHASE_CHUNK_SIZE;
+            return NULL;
+        case FF_HTTP_PHASE_TRAILER:
+            if (parser->line.length == 0)
+                parser->phase = FF_HTTP_PHASE_DONE;
+            return NULL;
+        default:
+            return parseHeaderLine(parser);
+    }
+}
+
+const char* ffHttpParserFeed(FFHttpParser* parser, const char* data, uint32_t length)
+{
+    const char* end = data + length;
+    while (data < end && parser->phase != FF_HTTP_PHASE_DONE)
+    {
+        switch (parser->phase)
         {
-            ffStrbufAppendF(&newBuffer, "Content-Length: %u\r\n", decompressedSize);
-            continue;
+            case FF_HTTP_PHASE_BODY:
+            case FF_HTTP_PHASE_CHUNK_DATA: {
+                uint32_t size = (uint32_t) (end - data);
+                if (size > parser->remaining) size = parser->remaining;
+                const char* error = emitBody(parser, data, size);
+                if (error) return error;
+                data += size;
+                parser->remaining -= size;
+                if (parser->remaining == 0)
+                    parser->phase = parser->phase == FF_HTTP_PHASE_BODY ? FF_HTTP_PHASE_DONE : FF_HTTP_PHASE_CHUNK_DATA_END;
+                break;
+            }
+            case FF_HTTP_PHASE_BODY_UNTIL_EOF: {
+                const char* error = emitBody(parser, data, (uint32_t) (end - data));
+                if (error) return error;
+                data = end;
+                break;
+            }
+            default: {
+                // Line based phases
+                const char* lf = memchr(data, '\n', (size_t) (end - data));
+                const char* lineEnd = lf ? lf : end;
+                ffStrbufAppendNS(&parser->line, (uint32_t) (lineEnd - data), data);
+                if (parser->line.length > FF_HTTP_MAX_LINE_LENGTH)
+                    return "HTTP header line too long";
+                data = lf ? lf + 1 : end;
+                if (!lf) break;
+
+                ffStrbufTrimRight(&parser->line, '\r');
+                const char* error = parseChunkLine(parser);
+                ffStrbufClear(&parser->line);
+                if (error) return error;
+                break;
+            }
         }
-        else if (line[0] == '\r')
-        {
-            ffStrbufAppendS(&newBuffer, "\r\n");
-            ffStrbufGetlineRestore(&line, &len, buffer);
+    }
+    return NULL;
+}
+
+const char* ffHttpParserFinish(FFHttpParser* parser)
+{
+    switch (parser->phase)
+    {
+        case FF_HTTP_PHASE_DONE:
             break;
-        }
+        case FF_HTTP_PHASE_BODY_UNTIL_EOF:
+            parser->phase = FF_HTTP_PHASE_DONE;
+            break;
+        case FF_HTTP_PHASE_STATUS_LINE:
+            return parser->line.length == 0 && parser->statusCode == 0 ? "Empty server response received" : "No HTTP header end found";
+        case FF_HTTP_PHASE_HEADER:
+            return "No HTTP header end found";
+        case FF_HTTP_PHASE_BODY:
+            FF_DEBUG("Content length mismatches: %u bytes missing", parser->remaining);
+            return "Content length mismatch";
+        default:
+            return "Incomplete chunked response";
+    }
 
-        ffStrbufAppendS(&newBuffer, line);
-        ffStrbufAppendC(&newBuffer, '\n');
+    if (parser->statusCode != 200)
+    {
+        FF_DEBUG("Invalid response: HTTP status %u", parser->statusCode);
+        return "Invalid response";
     }
+    return NULL;
+}
 
-    ffStrbufAppend(&newBuffer, &decompressedBuffer);
-    ffStrbufDestroy(buffer);
-    ffStrbufInitMove(buffer, &newBuffer);
+static void getCacheFilePath(const char* key, FFstrbuf* path)
+{
+    // FNV-1a
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (const char* p = key; *p; ++p)
+        hash = (hash ^ (uint8_t) *p) * 0x100000001b3ULL;
+
+    ffStrbufSet(path, &instance.state.platform.cacheDir);
+    ffStrbufAppendF(path, "fastfetch/http/%016" PRIx64, hash);
+}
+
+bool ffNetworkingCacheRead(const char* key, uint32_t ttl, FFstrbuf* body)
+{
+    FF_STRBUF_AUTO_DESTROY path = ffStrbufCreate();
+    getCacheFilePath(key, &path);
+
+    // File format: "<write time in ms>\n<key>\n<body>"
+    FF_STRBUF_AUTO_DESTROY content = ffStrbufCreate();
+    if (!ffReadFileBuffer(path.chars, &content))
+        return false;
+
+    char* keyStart = NULL;
+    uint64_t writeTime = strtoull(content.chars, &keyStart, 10);
+    uint64_t now = ffTimeGetNow();
+    if (*keyStart != '\n' || writeTime > now || now - writeTime >= (uint64_t) ttl * 1000)
+    {
+        FF_DEBUG("Cache %s is missing or expired", path.chars);
+        return false;
+    }
+
+    ++keyStart;
+    size_t keyLength = strlen(key);
+    if (strncmp(keyStart, key, keyLength) != 0 || keyStart[keyLength] != '\n')
+    {
+        FF_DEBUG("Cache %s belongs to another request", path.chars);
+        return false;
+    }
 
+    ffStrbufSetS(body, keyStart + keyLength + 1);
+    FF_DEBUG("Loaded %u bytes from cache %s", body->length, path.chars);
     return true;
 }
-#endif // FF_HAVE_ZLIB
+
+void ffNetworkingCacheWrite(const char* key, const FFstrbuf* body)
+{
+    FF_STRBUF_AUTO_DESTROY path = ffStrbufCreate();
+    getCacheFilePath(key, &path);
+
+    FF_STRBUF_AUTO_DESTROY content = ffStrbufCreateF("%" PRIu64 "\n%s\n", ffTimeGetNow(), key);
+    ffStrbufAppend(&content, body);
+    if (!ffWriteFileBuffer(path.chars, &content))
+        FF_DEBUG("Failed to write cache %s", path.chars);
+}
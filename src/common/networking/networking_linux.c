@@ -1,5 +1,6 @@
 #include "fastfetch.h"
 #include "common/networking/networking.h"
+#include "common/io/io.h"
 #include "common/time.h"
 #include "common/library.h"
 #include "util/stringUtils.h"
@@ -13,57 +14,413 @@
 #include <netdb.h>
 #include <netinet/in.h> // For FreeBSD
 #include <netinet/tcp.h>
+#include <arpa/inet.h>
 #include <errno.h>
+#include <inttypes.h>
 #include <fcntl.h>
 
-static const char* tryNonThreadingFastPath(FFNetworkingState* state)
+// Delay before racing the next resolved address (RFC 8305, "Connection Attempt Delay")
+#define FF_NETWORKING_ATTEMPT_DELAY 250
+#define FF_NETWORKING_RECV_SIZE 16384
+// getaddrinfo doesn't report record TTLs. Resolved addresses are reused for this long (in seconds)
+#define FF_NETWORKING_DNS_CACHE_TTL 600
+
+// Requests that have been sent but not finished yet. All of them are driven by one poll loop,
+// no matter which one the caller is waiting for, so that the total cost is max(RTT) instead of sum(RTT)
+static FFlist pendingStates = { .elementSize = sizeof(FFNetworkingState*) };
+
+static inline uint64_t getTick(void)
 {
-    #if defined(TCP_FASTOPEN) || __APPLE__
+    return (uint64_t) ffTimeGetTick();
+}
 
-        if (!state->tfo)
+static void closeFd(int* fd)
+{
+    if (*fd >= 0)
+    {
+        close(*fd);
+        *fd = -1;
+    }
+}
+
+static void freeAddresses(FFNetworkingState* state)
+{
+    if (state->addrFromCache)
+    {
+        // Built by loadCachedAddresses: one allocation per node
+        for (struct addrinfo* ai = state->addr; ai; )
         {
-            #ifdef __linux__
-            // Linux doesn't support sendto() on unconnected sockets
-            FF_DEBUG("TCP Fast Open disabled, skipping");
-            return "TCP Fast Open disabled";
-            #endif
+            struct addrinfo* next = ai->ai_next;
+            free(ai);
+            ai = next;
+        }
+    }
+    else if (state->addr)
+        freeaddrinfo(state->addr);
+    state->addr = state->nextAddr = NULL;
+    state->addrFromCache = false;
+}
+
+static bool getDnsCachePath(const FFNetworkingState* state, FFstrbuf* path)
+{
+    for (const char* p = state->host.chars; *p; ++p)
+    {
+        if (!ffCharIsEnglishAlphabet(*p) && !ffCharIsDigit(*p) && *p != '.' && *p != '-')
+            return false; // Not a plain host name
+    }
+
+    ffStrbufSet(path, &instance.state.platform.cacheDir);
+    ffStrbufAppendS(path, "fastfetch/dns/");
+    ffStrbufAppend(path, &state->host);
+    if (!state->dualStack)
+        ffStrbufAppendS(path, state->ipv6 ? "-v6" : "-v4");
+    return true;
+}
+
+// Cache file format: "<write time in ms>\n<address>\n<address>\n..."
+static bool loadCachedAddresses(FFNetworkingState* state)
+{
+    FF_STRBUF_AUTO_DESTROY path = ffStrbufCreate();
+    if (!getDnsCachePath(state, &path))
+        return false;
+
+    FF_STRBUF_AUTO_DESTROY content = ffStrbufCreate();
+    if (!ffReadFileBuffer(path.chars, &content))
+        return false;
+
+    char* line = NULL;
+    uint64_t writeTime = strtoull(content.chars, &line, 10);
+    uint64_t now = ffTimeGetNow();
+    if (*line != '\n' || writeTime > now || now - writeTime >= FF_NETWORKING_DNS_CACHE_TTL * 1000)
+    {
+        FF_DEBUG("DNS cache %s is missing or expired", path.chars);
+        return false;
+    }
+
+    struct addrinfo** tail = &state->addr;
+    for (++line; *line; )
+    {
+        char* lineEnd = strchr(line, '\n');
+        if (lineEnd) *lineEnd = '\0';
+
+        struct { struct addrinfo ai; struct sockaddr_storage ss; }* node = calloc(1, sizeof(*node));
+        node->ai.ai_socktype = SOCK_STREAM;
+        node->ai.ai_protocol = IPPROTO_TCP;
+        node->ai.ai_addr = (struct sockaddr*) &node->ss;
+
+        struct sockaddr_in* sin = (struct sockaddr_in*) &node->ss;
+        struct sockaddr_in6* sin6 = (struct sockaddr_in6*) &node->ss;
+        if (inet_pton(AF_INET, line, &sin->sin_addr) == 1)
+        {
+            node->ai.ai_family = sin->sin_family = AF_INET;
+            sin->sin_port = htons(80);
+            node->ai.ai_addrlen = sizeof(*sin);
+        }
+        else if (inet_pton(AF_INET6, line, &sin6->sin6_addr) == 1)
+        {
+            node->ai.ai_family = sin6->sin6_family = AF_INET6;
+            sin6->sin6_port = htons(80);
+            node->ai.ai_addrlen = sizeof(*sin6);
         }
         else
+            free(node), node = NULL;
+
+        if (node)
+        {
+            *tail = &node->ai;
+            tail = &node->ai.ai_next;
+        }
+
+        if (!lineEnd) break;
+        line = lineEnd + 1;
+    }
+
+    if (!state->addr)
+        return false;
+
+    FF_DEBUG("Loaded cached addresses of %s from %s", state->host.chars, path.chars);
+    state->addrFromCache = true;
+    state->nextAddr = state->addr;
+    return true;
+}
+
+static void saveCachedAddresses(const FFNetworkingState* state)
+{
+    FF_STRBUF_AUTO_DESTROY path = ffStrbufCreate();
+    if (!getDnsCachePath(state, &path))
+        return;
+
+    FF_STRBUF_AUTO_DESTROY content = ffStrbufCreateF("%" PRIu64 "\n", ffTimeGetNow());
+    for (struct addrinfo* ai = state->addr; ai; ai = ai->ai_next)
+    {
+        char buf[INET6_ADDRSTRLEN];
+        const void* addr = ai->ai_family == AF_INET
+            ? (const void*) &((struct sockaddr_in*) ai->ai_addr)->sin_addr
+            : (const void*) &((struct sockaddr_in6*) ai->ai_addr)->sin6_addr;
+        if (inet_ntop(ai->ai_family, addr, buf, sizeof(buf)))
+        {
+            ffStrbufAppendS(&content, buf);
+            ffStrbufAppendC(&content, '\n');
+        }
+    }
+    if (!ffWriteFileBuffer(path.chars, &content))
+        FF_DEBUG("Failed to write DNS cache %s", path.chars);
+}
+
+// Resolves `host` and interleaves the address families of the result (RFC 8305, section 4)
+static const char* resolveHost(const char* host, bool dualStack, bool ipv6, struct addrinfo** result)
+{
+    struct addrinfo hints = {
+        .ai_family = dualStack ? AF_UNSPEC : ipv6 ? AF_INET6 : AF_INET,
+        .ai_socktype = SOCK_STREAM,
+        .ai_flags = AI_NUMERICSERV | (dualStack ? AI_ADDRCONFIG : 0),
+    };
+
+    FF_DEBUG("Resolving address: %s (%s)", host, dualStack ? "IPv4 + IPv6" : ipv6 ? "IPv6" : "IPv4");
+    // Use AI_NUMERICSERV flag to indicate the service is a numeric port, reducing parsing time
+    int gaiError = getaddrinfo(host, "80", &hints, result);
+    if (gaiError != 0)
+    {
+        FF_DEBUG("getaddrinfo() failed: %s", gai_strerror(gaiError));
+        *result = NULL;
+        return "getaddrinfo() failed";
+    }
+    FF_DEBUG("Address resolution successful");
+
+    if (dualStack)
+    {
+        // Interleave address families, keeping the preference of getaddrinfo for the first one
+        struct addrinfo* first = *result;
+        struct addrinfo* tail = first;
+        struct addrinfo* other = NULL; struct addrinfo** otherTail = &other;
+        struct addrinfo* same = NULL; struct addrinfo** sameTail = &same;
+        for (struct addrinfo* ai = first->ai_next; ai; ai = ai->ai_next)
+        {
+            if (ai->ai_family == first->ai_family) { *sameTail = ai; sameTail = &ai->ai_next; }
+            else { *otherTail = ai; otherTail = &ai->ai_next; }
+        }
+        *sameTail = NULL;
+        *otherTail = NULL;
+        while (other || same)
         {
-            FF_DEBUG("Attempting to use TCP Fast Open to connect");
+            if (other) { tail->ai_next = other; tail = other; other = other->ai_next; }
+            if (same) { tail->ai_next = same; tail = same; same = same->ai_next; }
+        }
+        tail->ai_next = NULL;
+    }
+
+    return NULL;
+}
+
+static void setResolvedAddresses(FFNetworkingState* state, struct addrinfo* addr)
+{
+    state->addr = state->nextAddr = addr;
+    state->addrFromCache = false;
+    saveCachedAddresses(state);
+}
+
+static const char* resolveAddresses(FFNetworkingState* state)
+{
+    struct addrinfo* addr;
+    const char* error = resolveHost(state->host.chars, state->dualStack, state->ipv6, &addr);
+    if (error)
+        return error;
+    setResolvedAddresses(state, addr);
+    return NULL;
+}
+
+static void finishRequest(FFNetworkingState* state, const char* error);
+
+#ifdef FF_HAVE_THREADS
+
+// getaddrinfo() blocks. A resolve started while other requests are in flight runs in its own thread,
+// which wakes up the poll loop through a pipe when it's done
+typedef struct FFResolveJob
+{
+    FFstrbuf host;
+    bool dualStack;
+    bool ipv6;
+    struct addrinfo* addr; // Result, NULL if resolving failed
+    int pipeFds[2]; // Closed with the job, so that the thread never writes to a pipe without reader
+    uint32_t refs; // The request and the thread
+} FFResolveJob;
+
+static void releaseResolveJob(FFResolveJob* job)
+{
+    if (__atomic_sub_fetch(&job->refs, 1, __ATOMIC_ACQ_REL) > 0)
+        return;
+
+    if (job->addr)
+        freeaddrinfo(job->addr);
+    close(job->pipeFds[0]);
+    close(job->pipeFds[1]);
+    ffStrbufDestroy(&job->host);
+    free(job);
+}
+
+static void resolveInBackground(FFResolveJob* job)
+{
+    struct addrinfo* addr;
+    resolveHost(job->host.chars, job->dualStack, job->ipv6, &addr);
+    __atomic_store_n(&job->addr, addr, __ATOMIC_RELEASE);
+
+    char c = 0;
+    if (write(job->pipeFds[1], &c, 1) != 1)
+        FF_DEBUG("Failed to notify the poll loop: %s", strerror(errno));
+    releaseResolveJob(job);
+}
 
-            #ifndef __APPLE__ // On macOS, TCP_FASTOPEN doesn't seem to be needed
-            // Set TCP Fast Open
-            #ifdef __linux__
-            int flag = 5; // the queue length of pending packets
+FF_THREAD_ENTRY_DECL_WRAPPER(resolveInBackground, FFResolveJob*)
+
+// Returns false if no thread can be started. The caller must resolve synchronously then
+static bool startResolveJob(FFNetworkingState* state)
+{
+    FFResolveJob* job = malloc(sizeof(*job));
+    *job = (FFResolveJob) {
+        .dualStack = state->dualStack,
+        .ipv6 = state->ipv6,
+        .refs = 2,
+    };
+    if (pipe(job->pipeFds) != 0)
+    {
+        free(job);
+        return false;
+    }
+    fcntl(job->pipeFds[0], F_SETFD, FD_CLOEXEC);
+    fcntl(job->pipeFds[1], F_SETFD, FD_CLOEXEC);
+    ffStrbufInitCopy(&job->host, &state->host);
+
+    FFThreadType thread = ffThreadCreate(resolveInBackgroundThreadMain, job);
+    if (!thread)
+    {
+        job->refs = 1;
+        releaseResolveJob(job);
+        return false;
+    }
+    ffThreadDetach(thread);
+
+    state->resolveJob = job;
+    return true;
+}
+
+static int getResolveJobFd(const FFNetworkingState* state)
+{
+    return state->resolveJob->pipeFds[0];
+}
+
+static void onResolved(FFNetworkingState* state)
+{
+    FFResolveJob* job = state->resolveJob;
+    state->resolveJob = NULL;
+
+    struct addrinfo* addr = __atomic_exchange_n(&job->addr, NULL, __ATOMIC_ACQUIRE);
+    releaseResolveJob(job);
+
+    if (addr)
+        setResolvedAddresses(state, addr);
+    else
+        finishRequest(state, "getaddrinfo() failed");
+}
+
+static void cancelResolveJob(FFNetworkingState* state)
+{
+    if (state->resolveJob)
+    {
+        releaseResolveJob(state->resolveJob);
+        state->resolveJob = NULL;
+    }
+}
+
+#else
+
+static inline bool startResolveJob(FF_MAYBE_UNUSED FFNetworkingState* state) { return false; }
+static inline int getResolveJobFd(FF_MAYBE_UNUSED const FFNetworkingState* state) { return -1; }
+static inline void onResolved(FF_MAYBE_UNUSED FFNetworkingState* state) {}
+static inline void cancelResolveJob(FF_MAYBE_UNUSED FFNetworkingState* state) {}
+
+#endif
+
+static void finishRequest(FFNetworkingState* state, const char* error)
+{
+    if (error)
+        FF_DEBUG("Request finished with error: %s", error);
+    else
+        FF_DEBUG("Request finished successfully, body %u bytes", state->parser.body.length);
+
+    state->error = error;
+    state->done = true;
+    closeFd(&state->sockfd);
+    closeFd(&state->sockfdAlt);
+    cancelResolveJob(state);
+    freeAddresses(state);
+    ffStrbufDestroy(&state->host);
+    ffStrbufDestroy(&state->command);
+}
+
+static void setSocketOptions(FFNetworkingState* state, int sockfd)
+{
+    int flag = 1;
+    #ifdef TCP_NODELAY
+    // Disable Nagle's algorithm to reduce small packet transmission delay
+    if (setsockopt(sockfd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag)) != 0) {
+        FF_DEBUG("Failed to set TCP_NODELAY: %s", strerror(errno));
+    }
+    #endif
+
+    #ifdef TCP_QUICKACK
+    // Set TCP_QUICKACK option to avoid delayed acknowledgments
+    if (setsockopt(sockfd, IPPROTO_TCP, TCP_QUICKACK, &flag, sizeof(flag)) != 0) {
+        FF_DEBUG("Failed to set TCP_QUICKACK: %s", strerror(errno));
+    }
+    #endif
+
+    // Set larger initial receive buffer instead of small repeated receives
+    int rcvbuf = 65536; // 64KB
+    setsockopt(sockfd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+
+    if (state->timeout > 0)
+    {
+        FF_MAYBE_UNUSED uint32_t sec = state->timeout / 1000;
+        if (sec == 0) sec = 1;
+
+        #ifdef TCP_CONNECTIONTIMEOUT
+        setsockopt(sockfd, IPPROTO_TCP, TCP_CONNECTIONTIMEOUT, &sec, sizeof(sec));
+        #elif defined(TCP_KEEPINIT)
+        setsockopt(sockfd, IPPROTO_TCP, TCP_KEEPINIT, &sec, sizeof(sec));
+        #elif defined(TCP_USER_TIMEOUT)
+        setsockopt(sockfd, IPPROTO_TCP, TCP_USER_TIMEOUT, &state->timeout, sizeof(state->timeout));
+        #endif
+    }
+}
+
+// Sends the request in the SYN packet. Returns the number of bytes sent, or -1 if TFO is not usable
+static ssize_t tryTcpFastOpen(FFNetworkingState* state, int sockfd, const struct addrinfo* addr)
+{
+    #if defined(TCP_FASTOPEN) || __APPLE__
+
+        #ifndef __APPLE__ // On macOS, TCP_FASTOPEN doesn't seem to be needed
+        // Set TCP Fast Open
+        #ifdef __linux__
+        int flag = 5; // the queue length of pending packets
+        #else
+        int flag = 1; // enable TCP Fast Open
+        #endif
+        if (setsockopt(sockfd, IPPROTO_TCP,
+            #ifdef __APPLE__
+            // https://github.com/rust-lang/libc/pull/3135
+            0x218 // TCP_FASTOPEN_FORCE_ENABLE
             #else
-            int flag = 1; // enable TCP Fast Open
-            #endif
-            if (setsockopt(state->sockfd, IPPROTO_TCP,
-                #ifdef __APPLE__
-                // https://github.com/rust-lang/libc/pull/3135
-                0x218 // TCP_FASTOPEN_FORCE_ENABLE
-                #else
-                TCP_FASTOPEN
-                #endif
-                , &flag, sizeof(flag)) != 0) {
-                FF_DEBUG("Failed to set TCP_FASTOPEN option: %s", strerror(errno));
-                return "setsockopt(TCP_FASTOPEN) failed";
-            } else {
-                #ifdef __linux__
-                FF_DEBUG("Successfully set TCP_FASTOPEN option, queue length: %d", flag);
-                #elif defined(__APPLE__)
-                FF_DEBUG("Successfully set TCP_FASTOPEN_FORCE_ENABLE option");
-                #else
-                FF_DEBUG("Successfully set TCP_FASTOPEN option");
-                #endif
-            }
+            TCP_FASTOPEN
             #endif
+            , &flag, sizeof(flag)) != 0) {
+            FF_DEBUG("Failed to set TCP_FASTOPEN option: %s", strerror(errno));
+            return -1;
         }
+        #endif
 
         #ifndef __APPLE__
-        FF_DEBUG("Using sendto() + MSG_DONTWAIT to send %u bytes of data", state->command.length);
-        ssize_t sent = sendto(state->sockfd,
+        FF_DEBUG("Using sendto() + MSG_FASTOPEN to send %u bytes of data", state->command.length);
+        ssize_t sent = sendto(sockfd,
                                 state->command.chars,
                                 state->command.length,
             #ifdef MSG_FASTOPEN
@@ -72,124 +429,320 @@ static const char* tryNonThreadingFastPath(FFNetworkingState* state)
             #ifdef MSG_NOSIGNAL
                                 MSG_NOSIGNAL |
             #endif
-                                MSG_DONTWAIT,
-                                state->addr->ai_addr,
-                                state->addr->ai_addrlen);
+                                0,
+                                addr->ai_addr,
+                                addr->ai_addrlen);
         #else
-        if (fcntl(state->sockfd, F_SETFL, O_NONBLOCK) == -1) {
-            FF_DEBUG("fcntl(F_SETFL) failed: %s", strerror(errno));
-            return "fcntl(F_SETFL) failed";
-        }
         FF_DEBUG("Using connectx() to send %u bytes of data", state->command.length);
         // Use connectx to establish connection and send data in one call
-        size_t sent;
-        if (connectx(state->sockfd,
+        size_t sentx = 0;
+        ssize_t sent = connectx(sockfd,
             &(sa_endpoints_t) {
-                .sae_dstaddr = state->addr->ai_addr,
-                .sae_dstaddrlen = state->addr->ai_addrlen,
+                .sae_dstaddr = addr->ai_addr,
+                .sae_dstaddrlen = addr->ai_addrlen,
             },
-            SAE_ASSOCID_ANY, state->tfo ? CONNECT_DATA_IDEMPOTENT : 0,
+            SAE_ASSOCID_ANY, CONNECT_DATA_IDEMPOTENT,
             &(struct iovec) {
                 .iov_base = state->command.chars,
                 .iov_len = state->command.length,
-            }, 1, &sent, NULL) != 0) sent = 0;
-        if (fcntl(state->sockfd, F_SETFL, 0) == -1) {
-            FF_DEBUG("fcntl(F_SETFL) failed: %s", strerror(errno));
-            return "fcntl(F_SETFL) failed";
-        }
+            }, 1, &sentx, NULL) == 0 || errno == EINPROGRESS ? (ssize_t) sentx : -1;
         #endif
-        if (sent > 0 || (errno == EAGAIN || errno == EWOULDBLOCK
-            #ifdef __APPLE__
-            // On macOS EINPROGRESS means the connection cannot be completed immediately
-            // On Linux, it means the TFO cookie is not available locally
-            || errno == EINPROGRESS
-            #endif
-        ))
-        {
-            FF_DEBUG(
-                #ifdef __APPLE__
-                "connectx()"
-                #else
-                "sendto()"
-                #endif
-                " %s (sent=%zd, errno=%d: %s)", errno == 0 ? "succeeded" : "was in progress",
-                sent, errno, strerror(errno));
-            freeaddrinfo(state->addr);
-            state->addr = NULL;
-            ffStrbufDestroy(&state->command);
-            return NULL;
-        }
 
-        FF_DEBUG(
-            #ifdef __APPLE__
-            "connectx()"
-            #else
-            "sendto()"
-            #endif
-            " failed: %s (errno=%d)", strerror(errno), errno);
-        #ifdef __APPLE__
-        return "connectx() failed";
-        #else
-        return "sendto() failed";
-        #endif
+        if (sent >= 0)
+            return sent;
+
+        // On Linux, EINPROGRESS means the TFO cookie is not available locally.
+        // A regular SYN (with a cookie request) has been sent and no data is queued
+        if (errno == EINPROGRESS)
+            return 0;
+
+        FF_DEBUG("TCP Fast Open failed: %s (errno=%d)", strerror(errno), errno);
+        return -1;
     #else
-        FF_UNUSED(state);
-        return "TFO support is not available";
+        FF_UNUSED(state, sockfd, addr);
+        return -1;
     #endif
 }
 
-// Traditional connect and send function
-static const char* connectAndSend(FFNetworkingState* state)
+// Starts a non-blocking connection attempt to `state->nextAddr`
+static void startConnectionAttempt(FFNetworkingState* state)
 {
-    const char* ret = NULL;
-    FF_DEBUG("Using traditional connection method to connect");
+    int* slot = state->sockfd < 0 ? &state->sockfd : &state->sockfdAlt;
+    assert(*slot < 0);
 
-    FF_DEBUG("Attempting connect() to server...");
-    if(connect(state->sockfd, state->addr->ai_addr, state->addr->ai_addrlen) == -1)
+    while (state->nextAddr)
     {
+        struct addrinfo* addr = state->nextAddr;
+        state->nextAddr = addr->ai_next;
+        state->nextAttemptTime = getTick() + FF_NETWORKING_ATTEMPT_DELAY;
+
+        FF_DEBUG("Starting connection attempt (family=%s)", addr->ai_family == AF_INET6 ? "IPv6" : "IPv4");
+        int sockfd = socket(addr->ai_family, addr->ai_socktype, addr->ai_protocol);
+        if (sockfd < 0)
+        {
+            FF_DEBUG("socket() failed: %s (errno=%d)", strerror(errno), errno);
+            continue;
+        }
+        fcntl(sockfd, F_SETFD, FD_CLOEXEC);
+        if (fcntl(sockfd, F_SETFL, fcntl(sockfd, F_GETFL) | O_NONBLOCK) == -1)
+        {
+            FF_DEBUG("fcntl(F_SETFL) failed: %s", strerror(errno));
+            close(sockfd);
+            continue;
+        }
+        setSocketOptions(state, sockfd);
+
+        // Only the first attempt carries data in its SYN packet, so that the request is never sent twice
+        if (state->tfo && state->commandSent == 0 && state->sockfdAlt < 0 && slot == &state->sockfd)
+        {
+            ssize_t sent = tryTcpFastOpen(state, sockfd, addr);
+            if (sent >= 0)
+            {
+                FF_DEBUG("TCP Fast Open in progress, %zd bytes sent with SYN", sent);
+                state->commandSent = (uint32_t) sent;
+                *slot = sockfd;
+                return;
+            }
+        }
+
+        if (connect(sockfd, addr->ai_addr, addr->ai_addrlen) == 0 || errno == EINPROGRESS)
+        {
+            FF_DEBUG("connect() in progress: fd=%d", sockfd);
+            *slot = sockfd;
+            return;
+        }
+
         FF_DEBUG("connect() failed: %s (errno=%d)", strerror(errno), errno);
-        ret = "connect() failed";
-        goto error;
+        close(sockfd);
     }
-    FF_DEBUG("connect() succeeded");
+}
+
+static void onReadable(FFNetworkingState* state)
+{
+    char buffer[FF_NETWORKING_RECV_SIZE];
+    ssize_t received = recv(state->sockfd, buffer, sizeof(buffer), 0);
 
-    FF_DEBUG("Attempting to send %u bytes of data...", state->command.length);
-    if(send(state->sockfd, state->command.chars, state->command.length, 0) < 0)
+    if (received < 0)
     {
-        FF_DEBUG("send() failed: %s (errno=%d)", strerror(errno), errno);
-        ret = "send() failed";
-        goto error;
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+            return;
+        FF_DEBUG("recv() failed: %s (errno=%d)", strerror(errno), errno);
+        finishRequest(state, "recv() failed");
+        return;
     }
-    FF_DEBUG("Data sent successfully");
 
-    goto exit;
+    FF_DEBUG("Received %zd bytes of data", received);
 
-error:
-    FF_DEBUG("Error occurred, closing socket");
-    close(state->sockfd);
-    state->sockfd = -1;
+    const char* error = ffHttpParserFeed(&state->parser, buffer, (uint32_t) received);
+    if (error)
+        finishRequest(state, error);
+    else if (received == 0 || ffHttpParserIsDone(&state->parser))
+        // Don't wait for the server to close the connection if we already have the full response
+        finishRequest(state, ffHttpParserFinish(&state->parser));
+}
 
-exit:
-    FF_DEBUG("Releasing address info and other resources");
-    freeaddrinfo(state->addr);
-    state->addr = NULL;
-    ffStrbufDestroy(&state->command);
+static void onWritable(FFNetworkingState* state, int* slot)
+{
+    if (!state->connected)
+    {
+        int error = 0;
+        socklen_t len = sizeof(error);
+        if (getsockopt(*slot, SOL_SOCKET, SO_ERROR, &error, &len) != 0 || error != 0)
+        {
+            FF_DEBUG("Connection attempt failed: %s (fd=%d)", strerror(error), *slot);
+            closeFd(slot);
+            // Only `sockfd` may carry data in its SYN. The attempt that replaces it must send the whole request
+            if (slot == &state->sockfd)
+                state->commandSent = 0;
+            // Don't wait for the attempt delay if an attempt fails
+            if (state->nextAddr)
+                startConnectionAttempt(state);
+            return;
+        }
 
-    return ret;
+        FF_DEBUG("Connection established: fd=%d", *slot);
+        state->connected = true;
+        if (slot == &state->sockfdAlt)
+        {
+            // The alternative attempt won the race. The data in the SYN of the first one has never been acknowledged
+            closeFd(&state->sockfd);
+            state->sockfd = state->sockfdAlt;
+            state->sockfdAlt = -1;
+            state->commandSent = 0;
+        }
+        else
+            closeFd(&state->sockfdAlt);
+
+        freeAddresses(state);
+    }
+
+    while (state->commandSent < state->command.length)
+    {
+        ssize_t sent = send(state->sockfd,
+            state->command.chars + state->commandSent,
+            state->command.length - state->commandSent,
+            #ifdef MSG_NOSIGNAL
+            MSG_NOSIGNAL
+            #else
+            0
+            #endif
+        );
+        if (sent < 0)
+        {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+                return;
+            FF_DEBUG("send() failed: %s (errno=%d)", strerror(errno), errno);
+            finishRequest(state, "send() failed");
+            return;
+        }
+        state->commandSent += (uint32_t) sent;
+    }
+    FF_DEBUG("Request sent (%u bytes)", state->commandSent);
 }
 
-FF_THREAD_ENTRY_DECL_WRAPPER(connectAndSend, FFNetworkingState*);
+// Runs the event loop of all pending requests until `target` is finished
+static void driveRequests(FFNetworkingState* target)
+{
+    FF_AUTO_FREE struct pollfd* pfds = NULL;
+    FF_AUTO_FREE int** slots = NULL;
+    FF_AUTO_FREE FFNetworkingState** owners = NULL;
+    uint32_t capacity = 0;
+
+    while (!target->done)
+    {
+        uint64_t now = getTick();
+        int pollTimeout = -1;
+
+        if (capacity < pendingStates.length * 3)
+        {
+            capacity = pendingStates.length * 3; // sockfd, sockfdAlt and the resolve job
+            pfds = realloc(pfds, capacity * sizeof(*pfds));
+            slots = realloc(slots, capacity * sizeof(*slots));
+            owners = realloc(owners, capacity * sizeof(*owners));
+        }
+
+        nfds_t nfds = 0;
+        FF_LIST_FOR_EACH(FFNetworkingState*, pstate, pendingStates)
+        {
+            FFNetworkingState* state = *pstate;
+            if (state->done) continue;
+
+            if (state->deadline > 0 && now >= state->deadline)
+            {
+                finishRequest(state, "Timeout");
+                continue;
+            }
+
+            if (state->addrFromCache && !state->nextAddr && state->sockfd < 0 && state->sockfdAlt < 0)
+            {
+                // All cached addresses failed. They may be stale, resolve the host again
+                FF_DEBUG("Cached addresses didn't work, resolving %s again", state->host.chars);
+                freeAddresses(state);
+                if (!startResolveJob(state) && resolveAddresses(state) != NULL)
+                {
+                    finishRequest(state, "getaddrinfo() failed");
+                    continue;
+                }
+            }
+
+            if (!state->connected && state->nextAddr && (state->sockfd < 0 || (state->sockfdAlt < 0 && now >= state->nextAttemptTime)))
+                startConnectionAttempt(state);
+
+            if (state->resolveJob)
+            {
+                pfds[nfds] = (struct pollfd) {
+                    .fd = getResolveJobFd(state),
+                    .events = POLLIN,
+                };
+                slots[nfds] = NULL;
+                owners[nfds] = state;
+                ++nfds;
+            }
+            else if (state->sockfd < 0 && state->sockfdAlt < 0)
+            {
+                finishRequest(state, "connect() failed");
+                continue;
+            }
+
+            int* candidates[] = { &state->sockfd, &state->sockfdAlt };
+            for (uint32_t i = 0; i < ARRAY_SIZE(candidates); ++i)
+            {
+                if (*candidates[i] < 0) continue;
+                pfds[nfds] = (struct pollfd) {
+                    .fd = *candidates[i],
+                    .events = (short) (!state->connected || state->commandSent < state->command.length ? POLLOUT : POLLIN),
+                };
+                slots[nfds] = candidates[i];
+                owners[nfds] = state;
+                ++nfds;
+            }
+
+            uint64_t wakeup = state->deadline;
+            if (!state->connected && state->nextAddr && state->sockfdAlt < 0 && (wakeup == 0 || state->nextAttemptTime < wakeup))
+                wakeup = state->nextAttemptTime;
+            if (wakeup > 0)
+            {
+                int ms = wakeup > now ? (int) (wakeup - now) : 0;
+                if (pollTimeout < 0 || ms < pollTimeout)
+                    pollTimeout = ms;
+            }
+        }
+
+        if (target->done)
+            break;
+
+        if (poll(pfds, nfds, pollTimeout) < 0)
+        {
+            if (errno == EINTR) continue;
+            FF_DEBUG("poll() failed: %s (errno=%d)", strerror(errno), errno);
+            finishRequest(target, "poll() failed");
+            break;
+        }
+
+        for (nfds_t i = 0; i < nfds; ++i)
+        {
+            FFNetworkingState* state = owners[i];
+            if (!pfds[i].revents || state->done)
+                continue;
+
+            if (!slots[i])
+            {
+                onResolved(state);
+                continue;
+            }
+
+            if (*slots[i] != pfds[i].fd)
+                continue; // The fd may have been closed or moved by a previous event of the same request
+
+            if (!state->connected || state->commandSent < state->command.length)
+                onWritable(state, slots[i]);
+            else
+                onReadable(state);
+        }
+    }
+}
 
-// Parallel DNS resolution and socket creation
 static const char* initNetworkingState(FFNetworkingState* state, const char* host, const char* path, const char* headers)
 {
     FF_DEBUG("Initializing network connection state: host=%s, path=%s", host, path);
 
+    state->sockfd = state->sockfdAlt = -1;
+    state->commandSent = 0;
+    ffStrbufInitS(&state->host, host);
+    state->addr = state->nextAddr = NULL;
+    state->addrFromCache = false;
+    state->resolveJob = NULL;
+    state->nextAttemptTime = 0;
+    state->deadline = state->timeout > 0 ? getTick() + state->timeout : 0;
+    ffHttpParserInit(&state->parser, state->compression);
+    state->error = NULL;
+    state->connected = state->done = false;
+
     // Initialize command and host information
     ffStrbufInitA(&state->command, 64);
     ffStrbufAppendS(&state->command, "GET ");
     ffStrbufAppendS(&state->command, path);
-    ffStrbufAppendS(&state->command, " HTTP/1.1\nHost: ");
+    ffStrbufAppendS(&state->command, " HTTP/1.1\r\nHost: ");
     ffStrbufAppendS(&state->command, host);
     ffStrbufAppendS(&state->command, "\r\n");
 
@@ -205,97 +758,19 @@ static const char* initNetworkingState(FFNetworkingState* state, const char* hos
     ffStrbufAppendS(&state->command, headers);
     ffStrbufAppendS(&state->command, "\r\n");
 
-    #ifdef FF_HAVE_THREADS
-    state->thread = 0;
-    FF_DEBUG("Thread ID initialized to 0");
-    #endif
-
-    const char* ret = NULL;
-
-    struct addrinfo hints = {
-        .ai_family = state->ipv6 ? AF_INET6 : AF_INET,
-        .ai_socktype = SOCK_STREAM,
-        .ai_flags = AI_NUMERICSERV
-    };
-
-    FF_DEBUG("Resolving address: %s (%s)", host, state->ipv6 ? "IPv6" : "IPv4");
-    // Use AI_NUMERICSERV flag to indicate the service is a numeric port, reducing parsing time
-
-    if(getaddrinfo(host, "80", &hints, &state->addr) != 0)
-    {
-        FF_DEBUG("getaddrinfo() failed: %s", gai_strerror(errno));
-        ret = "getaddrinfo() failed";
-        goto error;
-    }
-    FF_DEBUG("Address resolution successful");
-
-    FF_DEBUG("Creating socket");
-    state->sockfd = socket(state->addr->ai_family, state->addr->ai_socktype, state->addr->ai_protocol);
-    if(state->sockfd == -1)
-    {
-        FF_DEBUG("socket() failed: %s (errno=%d)", strerror(errno), errno);
-        ret = "socket() failed";
-        goto error;
-    }
-    FF_DEBUG("Socket creation successful: fd=%d", state->sockfd);
-
-    int flag = 1;
-    #ifdef TCP_NODELAY
-    // Disable Nagle's algorithm to reduce small packet transmission delay
-    if (setsockopt(state->sockfd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag)) != 0) {
-        FF_DEBUG("Failed to set TCP_NODELAY: %s", strerror(errno));
-    } else {
-        FF_DEBUG("Successfully disabled Nagle's algorithm");
-    }
-    #endif
-
-    #ifdef TCP_QUICKACK
-    // Set TCP_QUICKACK option to avoid delayed acknowledgments
-    if (setsockopt(state->sockfd, IPPROTO_TCP, TCP_QUICKACK, &flag, sizeof(flag)) != 0) {
-        FF_DEBUG("Failed to set TCP_QUICKACK: %s", strerror(errno));
-    } else {
-        FF_DEBUG("Successfully enabled TCP quick acknowledgment");
-    }
-    #endif
-
-    if (state->timeout > 0)
+    // Try the cached addresses first, so that the request doesn't wait for the resolver
+    if (!loadCachedAddresses(state))
     {
-        FF_DEBUG("Setting connection timeout: %u ms", state->timeout);
-        FF_MAYBE_UNUSED uint32_t sec = state->timeout / 1000;
-        if (sec == 0) sec = 1;
-
-        #ifdef TCP_CONNECTIONTIMEOUT
-        FF_DEBUG("Using TCP_CONNECTIONTIMEOUT: %u seconds", sec);
-        setsockopt(state->sockfd, IPPROTO_TCP, TCP_CONNECTIONTIMEOUT, &sec, sizeof(sec));
-        #elif defined(TCP_KEEPINIT)
-        FF_DEBUG("Using TCP_KEEPINIT: %u seconds", sec);
-        setsockopt(state->sockfd, IPPROTO_TCP, TCP_KEEPINIT, &sec, sizeof(sec));
-        #elif defined(TCP_USER_TIMEOUT)
-        FF_DEBUG("Using TCP_USER_TIMEOUT: %u milliseconds", state->timeout);
-        setsockopt(state->sockfd, IPPROTO_TCP, TCP_USER_TIMEOUT, &state->timeout, sizeof(state->timeout));
-        #else
-        FF_DEBUG("Current platform does not support TCP connection timeout");
-        #endif
+        const char* error = resolveAddresses(state);
+        if (error)
+        {
+            ffStrbufDestroy(&state->host);
+            ffStrbufDestroy(&state->command);
+            return error;
+        }
     }
 
     return NULL;
-
-error:
-    FF_DEBUG("Error occurred during initialization");
-    if (state->addr != NULL)
-    {
-        FF_DEBUG("Releasing address information");
-        freeaddrinfo(state->addr);
-        state->addr = NULL;
-    }
-
-    if (state->sockfd > 0)
-    {
-        FF_DEBUG("Closing socket: fd=%d", state->sockfd);
-        close(state->sockfd);
-        state->sockfd = -1;
-    }
-    return ret;
 }
 
 const char* ffNetworkingSendHttpRequest(FFNetworkingState* state, const char* host, const char* path, const char* headers)
@@ -329,172 +804,41 @@ const char* ffNetworkingSendHttpRequest(FFNetworkingState* state, const char* ho
     const char* initResult = initNetworkingState(state, host, path, headers);
     if (initResult != NULL) {
         FF_DEBUG("Initialization failed: %s", initResult);
+        state->done = true;
         return initResult;
     }
-    FF_DEBUG("Network state initialization successful");
 
-    const char* tfoResult = tryNonThreadingFastPath(state);
-    if (tfoResult == NULL) {
-        FF_DEBUG("TryNonThreadingFastPath() succeeded or in progress");
-        return NULL;
-    }
-    FF_DEBUG("TryNonThreadingFastPath() failed: %s, trying traditional connection", tfoResult);
-
-    #ifdef FF_HAVE_THREADS
-    if (instance.config.general.multithreading)
+    startConnectionAttempt(state);
+    if (state->sockfd < 0)
     {
-        FF_DEBUG("Multithreading mode enabled, creating connection thread");
-        state->thread = ffThreadCreate(connectAndSendThreadMain, state);
-        if (state->thread) {
-            FF_DEBUG("Thread creation successful: thread=%p", (void*)state->thread);
-            return NULL;
-        }
-        FF_DEBUG("Thread creation failed");
-    } else {
-        FF_DEBUG("Multithreading mode disabled, connecting in main thread");
+        finishRequest(state, "connect() failed");
+        return state->error;
     }
-    #endif
 
-    return connectAndSend(state);
+    *(FFNetworkingState**) ffListAdd(&pendingStates) = state;
+    FF_DEBUG("Request registered, %u request(s) pending", pendingStates.length);
+    return NULL;
 }
 
-const char* ffNetworkingRecvHttpResponse(FFNetworkingState* state, FFstrbuf* buffer)
+const char* ffNetworkingRecvHttpResponse(FFNetworkingState* state, FFstrbuf* body)
 {
     FF_DEBUG("Preparing to receive HTTP response");
-    uint32_t timeout = state->timeout;
 
-    #ifdef FF_HAVE_THREADS
-    if (state->thread)
-    {
-        FF_DEBUG("Connection thread is running, waiting for it to complete (timeout=%u ms)", timeout);
-        if (!ffThreadJoin(state->thread, timeout)) {
-            FF_DEBUG("Thread join failed or timed out");
-            return "ffThreadJoin() failed or timeout";
-        }
-        FF_DEBUG("Thread completed successfully");
-        state->thread = 0;
-    }
-    #endif
+    driveRequests(state);
 
-    if(state->sockfd == -1)
+    for (uint32_t i = 0; i < pendingStates.length; ++i)
     {
-        FF_DEBUG("Invalid socket, HTTP request might have failed");
-        return "ffNetworkingSendHttpRequest() failed";
+        if (*FF_LIST_GET(FFNetworkingState*, pendingStates, i) != state) continue;
+        memmove(FF_LIST_GET(FFNetworkingState*, pendingStates, i), FF_LIST_GET(FFNetworkingState*, pendingStates, i + 1), (pendingStates.length - i - 1) * sizeof(FFNetworkingState*));
+        --pendingStates.length;
+        break;
     }
 
-    // Set larger initial receive buffer instead of small repeated receives
-    int rcvbuf = 65536; // 64KB
-    setsockopt(state->sockfd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
-
-    #ifdef __APPLE__
-    // poll for the socket to be readable.
-    // Because of the non-blocking connectx() call, the connection might not be established yet
-    FF_DEBUG("Using poll() to check if socket is readable");
-    if (poll(&(struct pollfd) {
-        .fd = state->sockfd,
-        .events = POLLIN
-    }, 1, timeout > 0 ? (int) timeout : -1) == -1)
+    if (!state->error)
     {
-        FF_DEBUG("poll() failed: %s (errno=%d)", strerror(errno), errno);
-        close(state->sockfd);
-        state->sockfd = -1;
-        return "poll() failed";
+        ffStrbufDestroy(body);
+        ffStrbufInitMove(body, &state->parser.body);
     }
-    FF_DEBUG("Socket is readable, proceeding to receive data");
-    #else
-    if(timeout > 0)
-    {
-        FF_DEBUG("Setting receive timeout: %u ms", timeout);
-        struct timeval timev;
-        timev.tv_sec = timeout / 1000;
-        timev.tv_usec = (__typeof__(timev.tv_usec)) ((timeout % 1000) * 1000); //milliseconds to microseconds
-        setsockopt(state->sockfd, SOL_SOCKET, SO_RCVTIMEO, &timev, sizeof(timev));
-    }
-    #endif
-
-    FF_DEBUG("Starting data reception");
-    FF_MAYBE_UNUSED int recvCount = 0;
-    uint32_t contentLength = 0;
-    char* headerEnd = NULL;
-
-    do {
-        FF_DEBUG("Data reception loop #%d, current buffer size: %u, available space: %u",
-                 ++recvCount, buffer->length, ffStrbufGetFree(buffer));
-
-        ssize_t received = recv(state->sockfd, buffer->chars + buffer->length, ffStrbufGetFree(buffer), MSG_WAITALL);
-
-        if (received <= 0) {
-            if (received == 0) {
-                FF_DEBUG("Connection closed (received=0)");
-            } else {
-                FF_DEBUG("Reception failed: %s (errno=%d)", strerror(errno), errno);
-            }
-            break;
-        }
-
-        buffer->length += (uint32_t) received;
-        buffer->chars[buffer->length] = '\0';
-
-        FF_DEBUG("Successfully received %zd bytes of data, total: %u bytes", received, buffer->length);
-
-        // Check if HTTP header end marker is found
-        if (headerEnd == NULL) {
-            headerEnd = memmem(buffer->chars, buffer->length, "\r\n\r\n", 4);
-            if (headerEnd != NULL) {
-                FF_DEBUG("Found HTTP header end marker, position: %ld", (long)(headerEnd - buffer->chars));
-
-                // Check for Content-Length header to pre-allocate enough memory
-                const char* clHeader = strcasestr(buffer->chars, "Content-Length:");
-                if (clHeader) {
-                    contentLength = (uint32_t) strtoul(clHeader + 16, NULL, 10);
-                    if (contentLength > 0) {
-                        FF_DEBUG("Detected Content-Length: %u, pre-allocating buffer", contentLength);
-                        // Ensure buffer is large enough, adding header size and some margin
-                        ffStrbufEnsureFree(buffer, contentLength + 16);
-                        FF_DEBUG("Extended receive buffer to %u bytes", buffer->length);
-                    }
-                }
-            }
-        }
-    } while (ffStrbufGetFree(buffer) > 0);
-
-    FF_DEBUG("Closing socket: fd=%d", state->sockfd);
-    close(state->sockfd);
-    state->sockfd = -1;
-
-    if (buffer->length == 0) {
-        FF_DEBUG("Server response is empty");
-        return "Empty server response received";
-    }
-
-    if (headerEnd == NULL) {
-        FF_DEBUG("No HTTP header end marker found");
-        return "No HTTP header end found";
-    }
-    if (contentLength > 0 && buffer->length != contentLength + (uint32_t)(headerEnd - buffer->chars) + 4) {
-        FF_DEBUG("Received content length mismatches: %u != %u", buffer->length, contentLength + (uint32_t)(headerEnd - buffer->chars) + 4);
-        return "Content length mismatch";
-    }
-
-    if (ffStrbufStartsWithS(buffer, "HTTP/1.1 200 OK\r\n")) {
-        FF_DEBUG("Received valid HTTP 200 response, content %u bytes, total %u bytes", contentLength, buffer->length);
-    } else {
-        FF_DEBUG("Invalid response: %.40s...", buffer->chars);
-        return "Invalid response";
-    }
-
-    // If compression was used, try to decompress
-    #ifdef FF_HAVE_ZLIB
-    if (state->compression) {
-        FF_DEBUG("Content received, checking if compressed");
-        if (!ffNetworkingDecompressGzip(buffer, headerEnd)) {
-            FF_DEBUG("Decompression failed or invalid compression format");
-            return "Failed to decompress or invalid format";
-        } else {
-            FF_DEBUG("Decompression successful or no decompression needed, total length after decompression: %u bytes", buffer->length);
-        }
-    }
-    #endif
-
-    return NULL;
+    ffHttpParserDestroy(&state->parser);
+    return state->error;
 }
@@ -213,7 +213,7 @@ const char* ffNetworkingSendHttpRequest(FFNetworkingState* state, const char* ho
     return NULL;
 }
 
-const char* ffNetworkingRecvHttpResponse(FFNetworkingState* state, FFstrbuf* buffer)
+const char* ffNetworkingRecvHttpResponse(FFNetworkingState* state, FFstrbuf* body)
 {
     FF_DEBUG("Preparing to receive HTTP response");
 
@@ -256,84 +256,44 @@ const char* ffNetworkingRecvHttpResponse(FFNetworkingState* state, FFstrbuf* buf
 
     FF_DEBUG("Starting data reception");
     FF_MAYBE_UNUSED int recvCount = 0;
-    uint32_t contentLength = 0;
-    char* headerEnd = NULL;
+    FFHttpParser parser;
+    ffHttpParserInit(&parser, state->compression);
+    const char* error = NULL;
+    char recvBuffer[16384];
 
     do {
-        FF_DEBUG("Data reception loop #%d, current buffer size: %u, available space: %u",
-                 ++recvCount, buffer->length, ffStrbufGetFree(buffer));
+        FF_DEBUG("Data reception loop #%d, current body size: %u", ++recvCount, parser.body.length);
 
-        ssize_t received = recv(state->sockfd, buffer->chars + buffer->length, (int)ffStrbufGetFree(buffer), 0);
+        ssize_t received = recv(state->sockfd, recvBuffer, (int) sizeof(recvBuffer), 0);
 
-        if (received <= 0) {
-            if (received == 0) {
-                FF_DEBUG("Connection closed (received=0)");
-            } else {
-                FF_DEBUG("Reception failed: %s", ffDebugWin32Error((DWORD) WSAGetLastError()));
-            }
+        if (received < 0) {
+            FF_DEBUG("Reception failed: %s", ffDebugWin32Error((DWORD) WSAGetLastError()));
             break;
         }
-
-        buffer->length += (uint32_t) received;
-        buffer->chars[buffer->length] = '\0';
-
-        FF_DEBUG("Successfully received %zd bytes of data, total: %u bytes", received, buffer->length);
-
-        // Check if HTTP header end marker is found
-        if (headerEnd == NULL) {
-            headerEnd = strstr(buffer->chars, "\r\n\r\n");
-            if (headerEnd != NULL) {
-                FF_DEBUG("Found HTTP header end marker, position: %ld", (long)(headerEnd - buffer->chars));
-
-                // Check for Content-Length header to pre-allocate enough memory
-                const char* clHeader = strcasestr(buffer->chars, "Content-Length:");
-                if (clHeader) {
-                    contentLength = (uint32_t) strtoul(clHeader + 16, NULL, 10);
-                    if (contentLength > 0) {
-                        FF_DEBUG("Detected Content-Length: %u, pre-allocating buffer", contentLength);
-                        // Ensure buffer is large enough, adding header size and some margin
-                        ffStrbufEnsureFree(buffer, contentLength + 16);
-                        FF_DEBUG("Extended receive buffer to %u bytes", buffer->allocated);
-                    }
-                }
-            }
+        if (received == 0) {
+            FF_DEBUG("Connection closed (received=0)");
+            break;
         }
-    } while (ffStrbufGetFree(buffer) > 0);
+
+        FF_DEBUG("Successfully received %zd bytes of data", received);
+        error = ffHttpParserFeed(&parser, recvBuffer, (uint32_t) received);
+    } while (error == NULL && !ffHttpParserIsDone(&parser)); // Stop as soon as the full response is received
 
     FF_DEBUG("Closing socket: fd=%u", (unsigned)state->sockfd);
     closesocket(state->sockfd);
     state->sockfd = INVALID_SOCKET;
 
-    if (buffer->length == 0) {
-        FF_DEBUG("Server response is empty");
-        return "Empty server response received";
-    }
+    if (error == NULL)
+        error = ffHttpParserFinish(&parser);
 
-    if (headerEnd == NULL) {
-        FF_DEBUG("No HTTP header end marker found");
-        return "No HTTP header end found";
-    }
-
-    if (ffStrbufStartsWithS(buffer, "HTTP/1.1 200 OK\r\n")) {
-        FF_DEBUG("Received valid HTTP 200 response, content length: %u bytes, total length: %u bytes",
-                contentLength, buffer->length);
+    if (error == NULL) {
+        FF_DEBUG("Received valid HTTP 200 response, body length: %u bytes", parser.body.length);
+        ffStrbufDestroy(body);
+        ffStrbufInitMove(body, &parser.body);
     } else {
-        FF_DEBUG("Invalid response: %.40s...", buffer->chars);
-        return "Invalid response";
+        FF_DEBUG("Invalid response: %s", error);
     }
 
-    // If compression was used, try to decompress
-    #ifdef FF_HAVE_ZLIB
-    if (state->compression) {
-        FF_DEBUG("Content received, checking if compressed");
-        if (!ffNetworkingDecompressGzip(buffer, headerEnd)) {
-            FF_DEBUG("Decompression failed or invalid compression format");
-            return "Failed to decompress or invalid format";
-        } else {
-            FF_DEBUG("Decompression successful or no decompression needed, total length after decompression: %u bytes", buffer->length);
-        }
-    }
-    #endif
-
-    return NULL;
+    ffHttpParserDestroy(&parser);
+    return error;
 }
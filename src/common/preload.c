@@ -0,0 +1,76 @@
+#include "common/preload.h"
+#include "common/library.h"
+#include "modules/modules.h"
+
+#include <stdlib.h>
+#include <strings.h>
+
+static inline bool isModule(const char* moduleName, uint32_t moduleNameLength, const char* name)
+{
+    return strlen(name) == moduleNameLength && strncasecmp(moduleName, name, moduleNameLength) == 0;
+}
+
+void ffPreloadModuleLibraries(FF_MAYBE_UNUSED const char* moduleName, FF_MAYBE_UNUSED uint32_t moduleNameLength)
+{
+    #ifdef FF_HAVE_VULKAN
+    if (isModule(moduleName, moduleNameLength, FF_VULKAN_MODULE_NAME))
+    {
+        #if __APPLE__
+            ffLibraryPreload("libMoltenVK" FF_LIBRARY_EXTENSION, -1, NULL);
+        #elif _WIN32
+            ffLibraryPreload("vulkan-1" FF_LIBRARY_EXTENSION, -1, NULL);
+        #else
+            ffLibraryPreload("libvulkan" FF_LIBRARY_EXTENSION, 2, NULL);
+        #endif
+        return;
+    }
+    #endif
+
+    #ifdef FF_HAVE_EGL
+    if (isModule(moduleName, moduleNameLength, FF_OPENGL_MODULE_NAME))
+    {
+        ffLibraryPreload("libEGL" FF_LIBRARY_EXTENSION, 1, NULL);
+        return;
+    }
+    #endif
+
+    #ifdef FF_HAVE_DBUS
+    if (isModule(moduleName, moduleNameLength, FF_MEDIA_MODULE_NAME) ||
+        isModule(moduleName, moduleNameLength, FF_PLAYER_MODULE_NAME))
+    {
+        ffLibraryPreload("libdbus-1" FF_LIBRARY_EXTENSION, 4, NULL);
+        return;
+    }
+    #endif
+
+    #ifdef FF_HAVE_PULSE
+    if (isModule(moduleName, moduleNameLength, FF_SOUND_MODULE_NAME))
+    {
+        ffLibraryPreload("libpulse" FF_LIBRARY_EXTENSION, 0, NULL);
+        return;
+    }
+    #endif
+
+    #if defined(FF_HAVE_WAYLAND) || defined(FF_HAVE_XCB_RANDR)
+    if (instance.config.general.dsForceDrm == FF_DS_FORCE_DRM_TYPE_FALSE && (
+        isModule(moduleName, moduleNameLength, FF_DISPLAY_MODULE_NAME) ||
+        isModule(moduleName, moduleNameLength, FF_MONITOR_MODULE_NAME) ||
+        isModule(moduleName, moduleNameLength, FF_WM_MODULE_NAME) ||
+        isModule(moduleName, moduleNameLength, FF_DE_MODULE_NAME)))
+    {
+        // Only the library of the display server that is going to be tried first
+        #ifdef FF_HAVE_WAYLAND
+        if (getenv("WAYLAND_DISPLAY"))
+        {
+            ffLibraryPreload("libwayland-client" FF_LIBRARY_EXTENSION, 1, NULL);
+            return;
+        }
+        #endif
+        #ifdef FF_HAVE_XCB_RANDR
+        if (getenv("DISPLAY"))
+            ffLibraryPreload("libxcb-randr" FF_LIBRARY_EXTENSION, 1, NULL);
+        #endif
+        return;
+    }
+    #endif
+}
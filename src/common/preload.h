@@ -0,0 +1,6 @@
+#pragma once
+
+#include "fastfetch.h"
+
+// Starts loading the shared libraries that the given module will load during detection in a background thread
+void ffPreloadModuleLibraries(const char* moduleName, uint32_t moduleNameLength);
@@ -28,3 +28,36 @@ bool ffProcessGetInfoWindows(uint32_t pid, uint32_t* ppid, FFstrbuf* pname, FFst
 void ffProcessGetInfoLinux(pid_t pid, FFstrbuf* processName, FFstrbuf* exe, const char** exeName, FFstrbuf* exePath);
 const char* ffProcessGetBasicInfoLinux(pid_t pid, FFstrbuf* name, pid_t* ppid, int32_t* tty);
 #endif
+
+#ifdef __linux__
+#include "util/FFlist.h"
+
+typedef enum __attribute__((__packed__)) FFProcessEntryFields
+{
+    FF_PROCESS_ENTRY_STAT = 1 << 0, // name, ppid, tty
+    FF_PROCESS_ENTRY_CMDLINE = 1 << 1,
+    FF_PROCESS_ENTRY_EXE = 1 << 2,
+    FF_PROCESS_ENTRY_LOGINUID = 1 << 3,
+} FFProcessEntryFields;
+
+typedef struct FFProcessEntry
+{
+    pid_t pid;
+    pid_t ppid;
+    int32_t tty; // tty_nr of /proc/pid/stat
+    uint32_t loginuid; // UINT32_MAX if unknown
+    FFstrbuf name; // comm
+    FFstrbuf cmdline; // raw, arguments are separated by '\0'
+    FFstrbuf exePath;
+    FFProcessEntryFields loaded;
+    bool statFailed;
+} FFProcessEntry;
+
+// Process table shared by all detections of one run. Every /proc/<pid> file is read at most once.
+// Returns NULL if `fields` includes FF_PROCESS_ENTRY_STAT and the process doesn't exist
+FFProcessEntry* ffProcessTableGet(pid_t pid, FFProcessEntryFields fields);
+// Returns false if `fields` includes FF_PROCESS_ENTRY_STAT and the process doesn't exist
+bool ffProcessTableLoad(FFProcessEntry* entry, FFProcessEntryFields fields);
+// All processes in /proc (list of FFProcessEntry*). Fields are loaded on demand with `ffProcessTableLoad`
+const FFlist* ffProcessTableList(void);
+#endif
@@ -11,6 +11,7 @@
 #include <fcntl.h>
 #include <errno.h>
 #include <sys/wait.h>
+#include <dirent.h>
 
 #if defined(__FreeBSD__) || defined(__APPLE__)
     #include <sys/types.h>
@@ -139,34 +140,166 @@ const char* ffProcessAppendOutput(FFstrbuf* buffer, char* const argv[], bool use
     return "read(childPipeFd, str, FF_PIPE_BUFSIZ) failed";
 }
 
-void ffProcessGetInfoLinux(pid_t pid, FFstrbuf* processName, FFstrbuf* exe, const char** exeName, FFstrbuf* exePath)
+#ifdef __linux__
+
+static FFlist processTable = { .elementSize = sizeof(FFProcessEntry*) }; // FFProcessEntry*
+static bool processTableListed;
+
+static FFProcessEntry* newProcessEntry(pid_t pid)
 {
-    assert(processName->length > 0);
-    ffStrbufClear(exe);
+    FFProcessEntry* entry = malloc(sizeof(*entry));
+    *entry = (FFProcessEntry) {
+        .pid = pid,
+        .tty = -1,
+        .loginuid = UINT32_MAX,
+        .name = ffStrbufCreate(),
+        .cmdline = ffStrbufCreate(),
+        .exePath = ffStrbufCreate(),
+    };
+    *(FFProcessEntry**) ffListAdd(&processTable) = entry;
+    return entry;
+}
 
-    #ifdef __linux__
+static FFProcessEntry* findProcessEntry(pid_t pid, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        FFProcessEntry* entry = *FF_LIST_GET(FFProcessEntry*, processTable, i);
+        if (entry->pid == pid)
+            return entry;
+    }
+    return NULL;
+}
+
+static bool loadStat(FFProcessEntry* entry)
+{
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%d/stat", (int) entry->pid);
+    char buf[PROC_FILE_BUFFSIZ];
+    ssize_t nRead = ffReadFileData(path, sizeof(buf) - 1, buf);
+    if (nRead <= 8)
+        return false;
+    buf[nRead] = '\0';
+
+    // pid (comm) state ppid pgrp session tty_nr; comm may contain spaces and parentheses
+    const char* nameStart = strchr(buf, '(');
+    const char* nameEnd = strrchr(buf, ')');
+    if (!nameStart || !nameEnd || nameEnd <= nameStart + 1)
+        return false;
+    ffStrbufSetNS(&entry->name, (uint32_t) (nameEnd - nameStart - 1), nameStart + 1);
+
+    int ppid = 0, tty = -1;
+    if (sscanf(nameEnd + 1, " %*c %d %*d %*d %d", &ppid, &tty) < 1)
+        return false;
+    entry->ppid = (pid_t) ppid;
+    entry->tty = tty;
+    return true;
+}
+
+bool ffProcessTableLoad(FFProcessEntry* entry, FFProcessEntryFields fields)
+{
+    FFProcessEntryFields missing = fields & ~entry->loaded;
+    entry->loaded |= missing;
 
-    char filePath[64];
-    snprintf(filePath, sizeof(filePath), "/proc/%d/cmdline", (int)pid);
+    char path[64];
 
-    if(ffReadFileBuffer(filePath, exe))
+    if (missing & FF_PROCESS_ENTRY_STAT)
+        entry->statFailed = !loadStat(entry);
+
+    if (missing & FF_PROCESS_ENTRY_CMDLINE)
     {
-        ffStrbufRecalculateLength(exe); //Trim the arguments
-        ffStrbufTrimRightSpace(exe);
-        ffStrbufTrimLeft(exe, '-'); //Login shells start with a dash
+        snprintf(path, sizeof(path), "/proc/%d/cmdline", (int) entry->pid);
+        ffReadFileBuffer(path, &entry->cmdline);
     }
 
-    if (exePath)
+    if (missing & FF_PROCESS_ENTRY_EXE)
     {
-        snprintf(filePath, sizeof(filePath), "/proc/%d/exe", (int)pid);
+        snprintf(path, sizeof(path), "/proc/%d/exe", (int) entry->pid);
         char buf[PATH_MAX];
-        ssize_t length = readlink(filePath, buf, PATH_MAX - 1);
+        ssize_t length = readlink(path, buf, PATH_MAX - 1);
         if (length > 0) // doesn't contain trailing NUL
+            ffStrbufSetNS(&entry->exePath, (uint32_t) length, buf);
+    }
+
+    if (missing & FF_PROCESS_ENTRY_LOGINUID)
+    {
+        snprintf(path, sizeof(path), "/proc/%d/loginuid", (int) entry->pid);
+        char buf[32];
+        ssize_t nRead = ffReadFileData(path, sizeof(buf) - 1, buf);
+        if (nRead > 0)
         {
-            buf[length] = '\0';
-            ffStrbufEnsureFixedLengthFree(exePath, (uint32_t)length);
-            ffStrbufAppendNS(exePath, (uint32_t)length, buf);
+            buf[nRead] = '\0';
+            entry->loginuid = (uint32_t) strtoul(buf, NULL, 10);
+        }
+    }
+
+    return !((fields & FF_PROCESS_ENTRY_STAT) && entry->statFailed);
+}
+
+FFProcessEntry* ffProcessTableGet(pid_t pid, FFProcessEntryFields fields)
+{
+    if (pid <= 0)
+        return NULL;
+
+    FFProcessEntry* entry = findProcessEntry(pid, processTable.length);
+    if (!entry)
+    {
+        if (processTableListed && (fields & FF_PROCESS_ENTRY_STAT))
+            return NULL; // Not in /proc when it was listed
+        entry = newProcessEntry(pid);
+    }
+
+    return ffProcessTableLoad(entry, fields) ? entry : NULL;
+}
+
+const FFlist* ffProcessTableList(void)
+{
+    if (processTableListed)
+        return &processTable;
+    processTableListed = true;
+
+    FF_AUTO_CLOSE_DIR DIR* dir = opendir("/proc");
+    if (dir == NULL)
+        return &processTable;
+
+    // Only entries queried before need to be checked for duplicates
+    uint32_t queried = processTable.length;
+
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL)
+    {
+        if (entry->d_type != DT_DIR || !ffCharIsDigit(entry->d_name[0]))
+            continue;
+
+        pid_t pid = (pid_t) strtol(entry->d_name, NULL, 10);
+        if (!findProcessEntry(pid, queried))
+            newProcessEntry(pid);
+    }
+
+    return &processTable;
+}
+
+#endif
+
+void ffProcessGetInfoLinux(pid_t pid, FFstrbuf* processName, FFstrbuf* exe, const char** exeName, FFstrbuf* exePath)
+{
+    assert(processName->length > 0);
+    ffStrbufClear(exe);
+
+    #ifdef __linux__
+
+    const FFProcessEntry* entry = ffProcessTableGet(pid, FF_PROCESS_ENTRY_CMDLINE | (exePath ? FF_PROCESS_ENTRY_EXE : 0));
+    if (entry)
+    {
+        if (entry->cmdline.length > 0)
+        {
+            ffStrbufSetS(exe, entry->cmdline.chars); //Trim the arguments
+            ffStrbufTrimRightSpace(exe);
+            ffStrbufTrimLeft(exe, '-'); //Login shells start with a dash
         }
+
+        if (exePath)
+            ffStrbufAppend(exePath, &entry->exePath);
     }
 
     #elif defined(__APPLE__)
@@ -346,39 +479,15 @@ const char* ffProcessGetBasicInfoLinux(pid_t pid, FFstrbuf* name, pid_t* ppid, i
 
     #ifdef __linux__
 
-    char procFilePath[64];
+    const FFProcessEntry* entry = ffProcessTableGet(pid, FF_PROCESS_ENTRY_STAT);
+    if (!entry)
+        return "ffReadFileData(/proc/pid/stat, PROC_FILE_BUFFSIZ-1, buf) failed";
+
+    ffStrbufSet(name, &entry->name);
     if (ppid)
-    {
-        snprintf(procFilePath, sizeof(procFilePath), "/proc/%d/stat", (int)pid);
-        char buf[PROC_FILE_BUFFSIZ];
-        ssize_t nRead = ffReadFileData(procFilePath, sizeof(buf) - 1, buf);
-        if(nRead <= 8)
-            return "ffReadFileData(/proc/pid/stat, PROC_FILE_BUFFSIZ-1, buf) failed";
-        buf[nRead] = '\0';
-
-        *ppid = 0;
-        static_assert(sizeof(*ppid) == sizeof(int), "");
-
-        ffStrbufEnsureFixedLengthFree(name, 255);
-        int tty_;
-        if(
-            sscanf(buf, "%*s (%255[^)]) %*c %d %*d %*d %d", name->chars, ppid, &tty_) < 2 || //stat (comm) state ppid pgrp session tty
-            name->chars[0] == '\0'
-        )
-            return "sscanf(stat) failed";
-
-        ffStrbufRecalculateLength(name);
-        if (tty)
-            *tty = tty_ & 0xFF;
-    }
-    else
-    {
-        snprintf(procFilePath, sizeof(procFilePath), "/proc/%d/comm", (int)pid);
-        ssize_t nRead = ffReadFileBuffer(procFilePath, name);
-        if(nRead <= 0)
-            return "ffReadFileBuffer(/proc/pid/comm, name) failed";
-        ffStrbufTrimRightSpace(name);
-    }
+        *ppid = entry->ppid;
+    if (tty)
+        *tty = entry->tty & 0xFF;
 
     #elif defined(__APPLE__)
 
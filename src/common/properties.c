@@ -170,3 +170,17 @@ bool ffParsePropFileListValues(const FFlist* list, const char* relativeFile, uin
 
     return foundAFile;
 }
+
+#ifdef __linux__
+bool ffParsePropSysfsValue(int dfd, const FFstrbuf* uevent, const char* ueventKey, const char* attr, FFstrbuf* buffer)
+{
+    ffStrbufClear(buffer);
+    if (uevent->length > 0 && ffParsePropLines(uevent->chars, ueventKey, buffer))
+        return true;
+
+    if (!ffReadFileBufferRelative(dfd, attr, buffer))
+        return false;
+    ffStrbufTrimRightSpace(buffer);
+    return true;
+}
+#endif
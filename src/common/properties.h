@@ -15,6 +15,13 @@ bool ffParsePropFileListValues(const FFlist* list, const char* relativeFile, uin
 
 bool ffParsePropLinePointer(const char** line, const char* start, FFstrbuf* buffer);
 
+#ifdef __linux__
+// `uevent` of a sysfs device (e.g. a power supply) contains all its properties as "<KEY>=<value>" lines.
+// Reading it once is much cheaper than reading each attribute, which may query the hardware every time.
+// The attribute `attr` of the device directory `dfd` is only read if `uevent` is empty or lacks `ueventKey` (old kernels)
+bool ffParsePropSysfsValue(int dfd, const FFstrbuf* uevent, const char* ueventKey, const char* attr, FFstrbuf* buffer);
+#endif
+
 static inline bool ffParsePropLine(const char* line, const char* start, FFstrbuf* buffer)
 {
     return ffParsePropLinePointer(&line, start, buffer);
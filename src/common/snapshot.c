@@ -0,0 +1,118 @@
+#include "common/snapshot.h"
+#include "common/io/io.h"
+#include "common/time.h"
+#include "util/stringUtils.h"
+
+#include <inttypes.h>
+
+static bool getBootId(FFstrbuf* bootId)
+{
+    #ifdef __linux__
+    if (!ffReadFileBuffer("/proc/sys/kernel/random/boot_id", bootId))
+        return false;
+    ffStrbufTrimRightSpace(bootId);
+    return bootId->length > 0;
+    #else
+    FF_UNUSED(bootId);
+    return false;
+    #endif
+}
+
+static void getSnapshotPath(const char* name, FFstrbuf* path)
+{
+    ffStrbufSet(path, &instance.state.platform.cacheDir);
+    ffStrbufAppendS(path, "fastfetch/snapshots/");
+    ffStrbufAppendS(path, name);
+}
+
+void ffSnapshotGetName(const char* base, const FFstrbuf* filter, FFstrbuf* name)
+{
+    ffStrbufSetS(name, base);
+    if (filter->length == 0)
+        return;
+
+    // FNV-1a
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (uint32_t i = 0; i < filter->length; ++i)
+        hash = (hash ^ (uint8_t) filter->chars[i]) * 0x100000001b3ULL;
+    ffStrbufAppendF(name, "-%016" PRIx64, hash);
+}
+
+// File format: "<boot id> <monotonic tick in ms>\n<content>"
+// The monotonic clock is used because the realtime clock may be adjusted between runs
+bool ffSnapshotLoad(const char* name, uint32_t maxAge, FFstrbuf* content, uint64_t* time)
+{
+    FF_STRBUF_AUTO_DESTROY bootId = ffStrbufCreate();
+    if (!getBootId(&bootId))
+        return false;
+
+    FF_STRBUF_AUTO_DESTROY path = ffStrbufCreate();
+    getSnapshotPath(name, &path);
+    if (!ffReadFileBuffer(path.chars, content))
+        return false;
+
+    if (!ffStrbufStartsWith(content, &bootId) || content->chars[bootId.length] != ' ')
+        return false; // Taken during another boot
+
+    char* end = NULL;
+    uint64_t tick = strtoull(content->chars + bootId.length + 1, &end, 10);
+    uint64_t tickNow = (uint64_t) ffTimeGetTick();
+    if (*end != '\n' || tick > tickNow || tickNow - tick > (uint64_t) maxAge * 1000)
+        return false;
+
+    ffStrbufSubstrAfter(content, (uint32_t) (end - content->chars));
+    *time = ffTimeGetNow() - (tickNow - tick);
+    return true;
+}
+
+void ffSnapshotSave(const char* name, uint64_t time, const FFstrbuf* content)
+{
+    FF_STRBUF_AUTO_DESTROY bootId = ffStrbufCreate();
+    if (!getBootId(&bootId))
+        return;
+
+    uint64_t now = ffTimeGetNow();
+    uint64_t tick = (uint64_t) ffTimeGetTick() - (now > time ? now - time : 0);
+
+    FF_STRBUF_AUTO_DESTROY path = ffStrbufCreate();
+    getSnapshotPath(name, &path);
+
+    FF_STRBUF_AUTO_DESTROY data = ffStrbufCreateF("%s %" PRIu64 "\n", bootId.chars, tick);
+    ffStrbufAppend(&data, content);
+    ffWriteFileBuffer(path.chars, &data);
+}
+
+void ffSnapshotAppendCounters(FFstrbuf* content, const FFstrbuf* key, const void* item, const size_t offsets[], uint32_t count)
+{
+    ffStrbufAppend(content, key);
+    ffStrbufAppendC(content, '\t');
+    for (uint32_t i = 0; i < count; ++i)
+        ffStrbufAppendF(content, i ? " %" PRIu64 : "%" PRIu64, *(const uint64_t*) ((const uint8_t*) item + offsets[i]));
+    ffStrbufAppendC(content, '\n');
+}
+
+bool ffSnapshotFindCounters(const FFstrbuf* content, const FFstrbuf* key, void* item, const size_t offsets[], uint32_t count)
+{
+    for (const char* line = content->chars; *line; )
+    {
+        const char* lineEnd = strchr(line, '\n');
+        if (!lineEnd) lineEnd = line + strlen(line);
+
+        if ((uint32_t) (lineEnd - line) > key->length && memcmp(line, key->chars, key->length) == 0 && line[key->length] == '\t')
+        {
+            const char* p = line + key->length + 1;
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                char* end;
+                uint64_t value = strtoull(p, &end, 10);
+                if (end == p || end > lineEnd) return false;
+                *(uint64_t*) ((uint8_t*) item + offsets[i]) = value;
+                p = end;
+            }
+            return true;
+        }
+
+        line = *lineEnd ? lineEnd + 1 : lineEnd;
+    }
+    return false;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "fastfetch.h"
+
+// Counter snapshots persisted in `cacheDir/fastfetch/snapshots/` across runs, so that
+// rate based modules (DiskIO, NetIO) can use the counters of the previous run as their first sample,
+// and expensive queries (PhysicalDisk health) can be reused for a while.
+// Snapshots are bound to the current boot. Only supported on Linux for now
+
+// Builds the name of a snapshot that depends on a device filter, so that module instances with different filters don't share one
+void ffSnapshotGetName(const char* base, const FFstrbuf* filter, FFstrbuf* name);
+
+// Loads the snapshot `name` if it was taken during this boot and isn't older than `maxAge` seconds.
+// `time` is the ffTimeGetNow() based time when the snapshot was taken
+bool ffSnapshotLoad(const char* name, uint32_t maxAge, FFstrbuf* content, uint64_t* time);
+void ffSnapshotSave(const char* name, uint64_t time, const FFstrbuf* content);
+
+// One line per device: "<key>\t<counter> <counter> ...". `offsets` are the offsets of the uint64_t counters in `item`
+void ffSnapshotAppendCounters(FFstrbuf* content, const FFstrbuf* key, const void* item, const size_t offsets[], uint32_t count);
+bool ffSnapshotFindCounters(const FFstrbuf* content, const FFstrbuf* key, void* item, const size_t offsets[], uint32_t count);
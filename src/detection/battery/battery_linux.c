@@ -1,5 +1,6 @@
 #include "battery.h"
 #include "common/io/io.h"
+#include "common/properties.h"
 #include "util/stringUtils.h"
 
 #include <dirent.h>
@@ -8,40 +9,59 @@
 
 // https://www.kernel.org/doc/Documentation/ABI/testing/sysfs-class-power
 
-static bool checkAc(const char* id, FFstrbuf* tmpBuffer)
+static bool checkAcLegacy(const char* id)
 {
+    const char* path;
     if (ffStrStartsWith(id, "BAT"))
-        ffStrbufSetS(tmpBuffer, "/sys/class/power_supply/ADP1/online");
+        path = "/sys/class/power_supply/ADP1/online";
     else if (ffStrStartsWith(id, "macsmc-battery"))
-        ffStrbufSetS(tmpBuffer, "/sys/class/power_supply/macsmc-ac/online");
+        path = "/sys/class/power_supply/macsmc-ac/online";
     else
-        ffStrbufClear(tmpBuffer);
+        return false;
 
     char online = '\0';
-    return ffReadFileData(tmpBuffer->chars, 1, &online) == 1 && online == '1';
+    return ffReadFileData(path, 1, &online) == 1 && online == '1';
 }
 
-static void parseBattery(int dfd, const char* id, FFBatteryOptions* options, FFlist* results)
+typedef enum FFAcState
 {
+    FF_AC_STATE_UNKNOWN, // No uevent of a mains supply found
+    FF_AC_STATE_OFFLINE,
+    FF_AC_STATE_ONLINE,
+} FFAcState;
+
+static bool checkAc(FFAcState acState, const char* id)
+{
+    if (acState == FF_AC_STATE_UNKNOWN)
+        return checkAcLegacy(id);
+    return acState == FF_AC_STATE_ONLINE;
+}
+
+typedef struct FFPowerSupply
+{
+    FFstrbuf id;
+    FFstrbuf uevent;
+    int dfd;
+} FFPowerSupply;
+
+static void parseBattery(const FFPowerSupply* supply, FFAcState acState, FFBatteryOptions* options, FFlist* results)
+{
+    int dfd = supply->dfd;
+    const FFstrbuf* uevent = &supply->uevent;
+    const char* id = supply->id.chars;
     FF_STRBUF_AUTO_DESTROY tmpBuffer = ffStrbufCreate();
 
     // type must exist and be "Battery"
-    if (!ffReadFileBufferRelative(dfd, "type", &tmpBuffer))
-        return;
-    ffStrbufTrimRightSpace(&tmpBuffer);
-    if(!ffStrbufIgnCaseEqualS(&tmpBuffer, "Battery"))
+    if (!ffParsePropSysfsValue(dfd, uevent, "POWER_SUPPLY_TYPE=", "type", &tmpBuffer) || !ffStrbufIgnCaseEqualS(&tmpBuffer, "Battery"))
         return;
 
     // scope may not exist or must not be "Device"
-    if (ffReadFileBufferRelative(dfd, "scope", &tmpBuffer))
-        ffStrbufTrimRightSpace(&tmpBuffer);
-
-    if(ffStrbufIgnCaseEqualS(&tmpBuffer, "Device"))
+    if (ffParsePropSysfsValue(dfd, uevent, "POWER_SUPPLY_SCOPE=", "scope", &tmpBuffer) && ffStrbufIgnCaseEqualS(&tmpBuffer, "Device"))
         return;
 
     // capacity must exist and be not empty
     // This is expensive in my laptop
-    if (!ffReadFileBufferRelative(dfd, "capacity", &tmpBuffer))
+    if (!ffParsePropSysfsValue(dfd, uevent, "POWER_SUPPLY_CAPACITY=", "capacity", &tmpBuffer) || tmpBuffer.length == 0)
         return;
 
     FFBatteryResult* result = ffListAdd(results);
@@ -50,38 +70,33 @@ static void parseBattery(int dfd, const char* id, FFBatteryOptions* options, FFl
     //At this point, we have a battery. Try to get as much values as possible.
 
     ffStrbufInit(&result->manufacturer);
-    if (ffReadFileBufferRelative(dfd, "manufacturer", &result->manufacturer))
-        ffStrbufTrimRightSpace(&result->manufacturer);
-    else if (ffStrEquals(id, "macsmc-battery")) // asahi
+    if (!ffParsePropSysfsValue(dfd, uevent, "POWER_SUPPLY_MANUFACTURER=", "manufacturer", &result->manufacturer) && ffStrEquals(id, "macsmc-battery")) // asahi
         ffStrbufSetStatic(&result->manufacturer, "Apple Inc.");
 
     ffStrbufInit(&result->modelName);
-    if (ffReadFileBufferRelative(dfd, "model_name", &result->modelName))
-        ffStrbufTrimRightSpace(&result->modelName);
+    ffParsePropSysfsValue(dfd, uevent, "POWER_SUPPLY_MODEL_NAME=", "model_name", &result->modelName);
 
     ffStrbufInit(&result->technology);
-    if (ffReadFileBufferRelative(dfd, "technology", &result->technology))
-        ffStrbufTrimRightSpace(&result->technology);
+    ffParsePropSysfsValue(dfd, uevent, "POWER_SUPPLY_TECHNOLOGY=", "technology", &result->technology);
 
     ffStrbufInit(&result->status);
-    if (ffReadFileBufferRelative(dfd, "status", &result->status))
-        ffStrbufTrimRightSpace(&result->status);
+    ffParsePropSysfsValue(dfd, uevent, "POWER_SUPPLY_STATUS=", "status", &result->status);
 
     // Unknown, Charging, Discharging, Not charging, Full
 
     result->timeRemaining = -1;
     if (ffStrbufEqualS(&result->status, "Discharging"))
     {
-        if (ffReadFileBufferRelative(dfd, "time_to_empty_now", &tmpBuffer))
+        if (ffParsePropSysfsValue(dfd, uevent, "POWER_SUPPLY_TIME_TO_EMPTY_NOW=", "time_to_empty_now", &tmpBuffer))
             result->timeRemaining = (int32_t) ffStrbufToSInt(&tmpBuffer, 0);
         else
         {
-            if (ffReadFileBufferRelative(dfd, "charge_now", &tmpBuffer))
+            if (ffParsePropSysfsValue(dfd, uevent, "POWER_SUPPLY_CHARGE_NOW=", "charge_now", &tmpBuffer))
             {
                 int64_t chargeNow = ffStrbufToSInt(&tmpBuffer, 0);
                 if (chargeNow > 0)
                 {
-                    if (ffReadFileBufferRelative(dfd, "current_now", &tmpBuffer))
+                    if (ffParsePropSysfsValue(dfd, uevent, "POWER_SUPPLY_CURRENT_NOW=", "current_now", &tmpBuffer))
                     {
                         int64_t currentNow = ffStrbufToSInt(&tmpBuffer, INT64_MIN);
                         if (currentNow < 0) currentNow = -currentNow;
@@ -92,7 +107,7 @@ static void parseBattery(int dfd, const char* id, FFBatteryOptions* options, FFl
             }
         }
 
-        if (checkAc(id, &tmpBuffer))
+        if (checkAc(acState, id))
             ffStrbufAppendS(&result->status, ", AC Connected");
     }
     else if (ffStrbufEqualS(&result->status, "Not charging") || ffStrbufEqualS(&result->status, "Full"))
@@ -102,13 +117,12 @@ static void parseBattery(int dfd, const char* id, FFBatteryOptions* options, FFl
     else if (ffStrbufEqualS(&result->status, "Unknown"))
     {
         ffStrbufClear(&result->status);
-        if (checkAc(id, &tmpBuffer))
+        if (checkAc(acState, id))
             ffStrbufAppendS(&result->status, "AC Connected");
     }
 
-    if (ffReadFileBufferRelative(dfd, "capacity_level", &tmpBuffer))
+    if (ffParsePropSysfsValue(dfd, uevent, "POWER_SUPPLY_CAPACITY_LEVEL=", "capacity_level", &tmpBuffer))
     {
-        ffStrbufTrimRightSpace(&result->manufacturer);
         if (ffStrbufEqualS(&tmpBuffer, "Critical"))
         {
             if (result->status.length)
@@ -119,27 +133,27 @@ static void parseBattery(int dfd, const char* id, FFBatteryOptions* options, FFl
     }
 
     ffStrbufInit(&result->serial);
-    if (ffReadFileBufferRelative(dfd, "serial_number", &result->serial))
-        ffStrbufTrimRightSpace(&result->serial);
+    ffParsePropSysfsValue(dfd, uevent, "POWER_SUPPLY_SERIAL_NUMBER=", "serial_number", &result->serial);
 
-    if (ffReadFileBufferRelative(dfd, "cycle_count", &tmpBuffer))
+    result->cycleCount = 0;
+    if (ffParsePropSysfsValue(dfd, uevent, "POWER_SUPPLY_CYCLE_COUNT=", "cycle_count", &tmpBuffer))
     {
         int64_t cycleCount = ffStrbufToSInt(&tmpBuffer, 0);
         result->cycleCount = cycleCount < 0 || cycleCount > UINT32_MAX ? 0 : (uint32_t) cycleCount;
     }
 
     ffStrbufInit(&result->manufactureDate);
-    if (ffReadFileBufferRelative(dfd, "manufacture_year", &tmpBuffer))
+    if (ffParsePropSysfsValue(dfd, uevent, "POWER_SUPPLY_MANUFACTURE_YEAR=", "manufacture_year", &tmpBuffer))
     {
         int year = (int) ffStrbufToSInt(&tmpBuffer, 0);
         if (year > 0)
         {
-            if (ffReadFileBufferRelative(dfd, "manufacture_month", &tmpBuffer))
+            if (ffParsePropSysfsValue(dfd, uevent, "POWER_SUPPLY_MANUFACTURE_MONTH=", "manufacture_month", &tmpBuffer))
             {
                 int month = (int) ffStrbufToSInt(&tmpBuffer, 0);
                 if (month > 0)
                 {
-                    if (ffReadFileBufferRelative(dfd, "manufacture_day", &tmpBuffer))
+                    if (ffParsePropSysfsValue(dfd, uevent, "POWER_SUPPLY_MANUFACTURE_DAY=", "manufacture_day", &tmpBuffer))
                     {
                         int day = (int) ffStrbufToSInt(&tmpBuffer, 0);
                         if (day > 0)
@@ -153,7 +167,7 @@ static void parseBattery(int dfd, const char* id, FFBatteryOptions* options, FFl
     result->temperature = FF_BATTERY_TEMP_UNSET;
     if (options->temp)
     {
-        if (ffReadFileBufferRelative(dfd, "temp", &tmpBuffer))
+        if (ffParsePropSysfsValue(dfd, uevent, "POWER_SUPPLY_TEMP=", "temp", &tmpBuffer))
             result->temperature = ffStrbufToDouble(&tmpBuffer) / 10;
     }
 }
@@ -164,14 +178,47 @@ const char* ffDetectBattery(FFBatteryOptions* options, FFlist* results)
     if(dirp == NULL)
         return "opendir(\"/sys/class/power_supply/\") == NULL";
 
+    // Read all supplies first, so that the AC state is known before parsing batteries
+    FF_LIST_AUTO_DESTROY supplies = ffListCreate(sizeof(FFPowerSupply));
+    FFAcState acState = FF_AC_STATE_UNKNOWN;
+    FF_STRBUF_AUTO_DESTROY tmpBuffer = ffStrbufCreate();
+
     struct dirent* entry;
     while((entry = readdir(dirp)) != NULL)
     {
         if(entry->d_name[0] == '.')
             continue;
 
-        FF_AUTO_CLOSE_FD int dfd = openat(dirfd(dirp), entry->d_name, O_RDONLY | O_CLOEXEC | O_PATH | O_DIRECTORY);
-        if (dfd > 0) parseBattery(dfd, entry->d_name, options, results);
+        int dfd = openat(dirfd(dirp), entry->d_name, O_RDONLY | O_CLOEXEC | O_PATH | O_DIRECTORY);
+        if (dfd < 0) continue;
+
+        FFPowerSupply* supply = ffListAdd(&supplies);
+        supply->dfd = dfd;
+        ffStrbufInitS(&supply->id, entry->d_name);
+        ffStrbufInit(&supply->uevent);
+        if (!ffReadFileBufferRelative(dfd, "uevent", &supply->uevent))
+            continue;
+
+        if (ffParsePropLines(supply->uevent.chars, "POWER_SUPPLY_TYPE=", &tmpBuffer) && ffStrbufIgnCaseEqualS(&tmpBuffer, "Mains"))
+        {
+            ffStrbufClear(&tmpBuffer);
+            if (ffParsePropLines(supply->uevent.chars, "POWER_SUPPLY_ONLINE=", &tmpBuffer))
+            {
+                if (ffStrbufEqualS(&tmpBuffer, "1"))
+                    acState = FF_AC_STATE_ONLINE;
+                else if (acState == FF_AC_STATE_UNKNOWN)
+                    acState = FF_AC_STATE_OFFLINE;
+            }
+        }
+        ffStrbufClear(&tmpBuffer);
+    }
+
+    FF_LIST_FOR_EACH(FFPowerSupply, supply, supplies)
+    {
+        parseBattery(supply, acState, options, results);
+        close(supply->dfd);
+        ffStrbufDestroy(&supply->id);
+        ffStrbufDestroy(&supply->uevent);
     }
 
     return NULL;
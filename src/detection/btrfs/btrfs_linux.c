@@ -1,7 +1,20 @@
 #include "btrfs.h"
 
 #include "common/io/io.h"
+#include "util/stringUtils.h"
+
 #include <fcntl.h>
+#include <mntent.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+
+#if __has_include(<linux/btrfs.h>) && __has_include(<linux/btrfs_tree.h>)
+#include <linux/fs.h>
+#include <linux/btrfs.h>
+#include <linux/btrfs_tree.h>
+#define FF_HAVE_BTRFS_IOCTL 1
+#endif
 
 enum { uuidLen = (uint32_t) __builtin_strlen("00000000-0000-0000-0000-000000000000") };
 
@@ -90,6 +103,172 @@ static const char* detectAllocation(FFBtrfsResult* item, int dfd, FFstrbuf* buff
     return NULL;
 }
 
+#ifdef FF_HAVE_BTRFS_IOCTL
+
+typedef struct FFBtrfsMount
+{
+    char uuid[uuidLen + 1];
+    int fd;
+} FFBtrfsMount;
+
+static void formatUuid(const uint8_t fsid[BTRFS_FSID_SIZE], char uuid[uuidLen + 1])
+{
+    snprintf(uuid, uuidLen + 1, "%02x%02x%02x%02x-%02x%02x-%02x%02x-%02x%02x-%02x%02x%02x%02x%02x%02x",
+        fsid[0], fsid[1], fsid[2], fsid[3], fsid[4], fsid[5], fsid[6], fsid[7],
+        fsid[8], fsid[9], fsid[10], fsid[11], fsid[12], fsid[13], fsid[14], fsid[15]);
+}
+
+// Open one mountpoint of every mounted btrfs filesystem. The ioctls work on any file of the filesystem
+static void collectMounts(FFlist* mounts /* list of FFBtrfsMount */)
+{
+    FILE* mountsFile = setmntent("/proc/self/mounts", "r");
+    if (!mountsFile) return;
+
+    struct mntent* device;
+    while ((device = getmntent(mountsFile)))
+    {
+        if (!ffStrEquals(device->mnt_type, "btrfs"))
+            continue;
+
+        int fd = open(device->mnt_dir, O_RDONLY | O_CLOEXEC | O_DIRECTORY);
+        if (fd < 0) continue;
+
+        struct btrfs_ioctl_fs_info_args fsInfo = {};
+        char uuid[uuidLen + 1];
+        if (ioctl(fd, BTRFS_IOC_FS_INFO, &fsInfo) < 0)
+        {
+            close(fd);
+            continue;
+        }
+        formatUuid(fsInfo.fsid, uuid);
+
+        bool found = false;
+        FF_LIST_FOR_EACH(FFBtrfsMount, mount, *mounts)
+        {
+            if (ffStrEquals(mount->uuid, uuid))
+            {
+                found = true;
+                break;
+            }
+        }
+        if (found)
+        {
+            // Another subvolume of the same filesystem
+            close(fd);
+            continue;
+        }
+
+        FFBtrfsMount* mount = ffListAdd(mounts);
+        memcpy(mount->uuid, uuid, sizeof(uuid));
+        mount->fd = fd;
+    }
+
+    endmntent(mountsFile);
+}
+
+// DEV_INFO reports the path used when the device was scanned (e.g. /dev/mapper/luks-xxx),
+// while sysfs lists kernel names (e.g. dm-0). Resolve the former to the latter
+static void appendDeviceName(FFstrbuf* devices, const char* path)
+{
+    char target[PATH_MAX];
+    struct stat st;
+    if (stat(path, &st) == 0 && S_ISBLK(st.st_mode))
+    {
+        char sysDevBlock[64];
+        snprintf(sysDevBlock, ARRAY_SIZE(sysDevBlock), "/sys/dev/block/%u:%u", major(st.st_rdev), minor(st.st_rdev));
+
+        ssize_t len = readlink(sysDevBlock, target, sizeof(target) - 1);
+        if (len > 0)
+        {
+            target[len] = '\0';
+            path = target;
+        }
+    }
+
+    const char* slash = strrchr(path, '/');
+    ffStrbufAppendS(devices, slash ? slash + 1 : path);
+}
+
+static const char* detectByIoctl(FFBtrfsResult* item, int fd)
+{
+    struct btrfs_ioctl_fs_info_args fsInfo = {
+        #ifdef BTRFS_FS_INFO_FLAG_GENERATION
+        .flags = BTRFS_FS_INFO_FLAG_GENERATION,
+        #endif
+    };
+    if (ioctl(fd, BTRFS_IOC_FS_INFO, &fsInfo) < 0)
+        return "ioctl(BTRFS_IOC_FS_INFO) failed";
+
+    // Data, metadata and system for each RAID profile, plus global reservation
+    struct {
+        struct btrfs_ioctl_space_args args;
+        struct btrfs_ioctl_space_info spaces[32];
+    } spaceInfo = { .args.space_slots = ARRAY_SIZE(spaceInfo.spaces) };
+    if (ioctl(fd, BTRFS_IOC_SPACE_INFO, &spaceInfo) < 0)
+        return "ioctl(BTRFS_IOC_SPACE_INFO) failed";
+
+    #ifdef BTRFS_IOC_GET_FSLABEL
+    char label[BTRFS_LABEL_SIZE] = "";
+    if (ioctl(fd, BTRFS_IOC_GET_FSLABEL, label) < 0)
+        return "ioctl(BTRFS_IOC_GET_FSLABEL) failed";
+    ffStrbufSetNS(&item->name, (uint32_t) strnlen(label, sizeof(label)), label);
+    #else
+    return "BTRFS_IOC_GET_FSLABEL is not supported";
+    #endif
+
+    // Device IDs may have holes after devices are removed
+    for (uint64_t devid = 1, found = 0; devid <= fsInfo.max_id && found < fsInfo.num_devices; ++devid)
+    {
+        struct btrfs_ioctl_dev_info_args devInfo = { .devid = devid };
+        if (ioctl(fd, BTRFS_IOC_DEV_INFO, &devInfo) < 0)
+            continue;
+        ++found;
+
+        if (item->devices.length)
+            ffStrbufAppendC(&item->devices, ',');
+        appendDeviceName(&item->devices, (const char*) devInfo.path);
+        item->totalSize += devInfo.total_bytes;
+    }
+
+    #ifdef BTRFS_FS_INFO_FLAG_GENERATION
+    if (fsInfo.flags & BTRFS_FS_INFO_FLAG_GENERATION)
+        item->generation = (uint32_t) fsInfo.generation;
+    #endif
+    item->nodeSize = fsInfo.nodesize;
+    item->sectorSize = fsInfo.sectorsize;
+
+    item->allocation[0].type = "data";
+    item->allocation[1].type = "metadata";
+    item->allocation[2].type = "system";
+    for (uint64_t i = 0; i < spaceInfo.args.total_spaces && i < ARRAY_SIZE(spaceInfo.spaces); ++i)
+    {
+        const struct btrfs_ioctl_space_info* space = &spaceInfo.spaces[i];
+        if (space->flags & BTRFS_SPACE_INFO_GLOBAL_RSV)
+        {
+            item->globalReservationTotal = space->total_bytes;
+            item->globalReservationUsed = space->used_bytes;
+            continue;
+        }
+
+        FFBtrfsDiskUsage* usage;
+        switch (space->flags & BTRFS_BLOCK_GROUP_TYPE_MASK)
+        {
+            case BTRFS_BLOCK_GROUP_DATA: usage = &item->allocation[0]; break;
+            case BTRFS_BLOCK_GROUP_METADATA: usage = &item->allocation[1]; break;
+            case BTRFS_BLOCK_GROUP_SYSTEM: usage = &item->allocation[2]; break;
+            default: continue; // mixed block groups are not reported by the sysfs path either
+        }
+        usage->total += space->total_bytes;
+        usage->used += space->used_bytes;
+        if (space->flags & BTRFS_BLOCK_GROUP_DUP)
+            usage->dup = true;
+    }
+
+    return NULL;
+}
+
+#endif
+
 const char* ffDetectBtrfs(FFlist* result)
 {
     FF_AUTO_CLOSE_DIR DIR* dirp = opendir("/sys/fs/btrfs/");
@@ -98,6 +277,13 @@ const char* ffDetectBtrfs(FFlist* result)
 
     FF_STRBUF_AUTO_DESTROY buffer = ffStrbufCreate();
 
+    #ifdef FF_HAVE_BTRFS_IOCTL
+    // FS_INFO, SPACE_INFO and DEV_INFO provide most values in a few syscalls,
+    // while sysfs requires reading several files for every device and allocation type
+    FF_LIST_AUTO_DESTROY mounts = ffListCreate(sizeof(FFBtrfsMount));
+    collectMounts(&mounts);
+    #endif
+
     struct dirent* entry;
     while ((entry = readdir(dirp)) != NULL)
     {
@@ -117,13 +303,40 @@ const char* ffDetectBtrfs(FFlist* result)
         FF_AUTO_CLOSE_FD int dfd = openat(dirfd(dirp), entry->d_name, O_RDONLY | O_CLOEXEC | O_PATH | O_DIRECTORY);
         if (dfd < 0) continue;
 
+        enumerateFeatures(item, dfd);
+
+        #ifdef FF_HAVE_BTRFS_IOCTL
+        bool detected = false;
+        FF_LIST_FOR_EACH(FFBtrfsMount, mount, mounts)
+        {
+            if (!ffStrEquals(mount->uuid, entry->d_name))
+                continue;
+
+            if (detectByIoctl(item, mount->fd) == NULL)
+                detected = true;
+            else
+            {
+                // Start over with sysfs
+                ffStrbufClear(&item->name);
+                ffStrbufClear(&item->devices);
+                item->totalSize = 0;
+                memset(item->allocation, 0, sizeof(item->allocation));
+            }
+            break;
+        }
+        if (detected)
+        {
+            if (item->generation == 0 && ffReadFileBufferRelative(dfd, "generation", &buffer)) // Linux < 5.15
+                item->generation = (uint32_t) ffStrbufToUInt(&buffer, 0);
+            continue;
+        }
+        #endif
+
         if (ffAppendFileBufferRelative(dfd, "label", &item->name))
             ffStrbufTrimRightSpace(&item->name);
 
         enumerateDevices(item, dfd, &buffer);
 
-        enumerateFeatures(item, dfd);
-
         if (ffReadFileBufferRelative(dfd, "generation", &buffer))
             item->generation = (uint32_t) ffStrbufToUInt(&buffer, 0);
 
@@ -136,5 +349,10 @@ const char* ffDetectBtrfs(FFlist* result)
         detectAllocation(item, dfd, &buffer);
     }
 
+    #ifdef FF_HAVE_BTRFS_IOCTL
+    FF_LIST_FOR_EACH(FFBtrfsMount, mount, mounts)
+        close(mount->fd);
+    #endif
+
     return NULL;
 }
@@ -1,15 +1,22 @@
 #include "disk.h"
 
 #include "common/io/io.h"
+#include "common/thread.h"
+#include "common/time.h"
+#include "util/debug.h"
+#include "util/mallocHelper.h"
 #include "util/stringUtils.h"
 
 #include <limits.h>
+#include <poll.h>
+#include <fcntl.h>
 #include <ctype.h>
 #include <dirent.h>
-#include <mntent.h>
 #include <sys/stat.h>
 #include <sys/statvfs.h>
 #include <sys/mount.h>
+#include <sys/syscall.h>
+#include <errno.h>
 
 #ifdef __USE_LARGEFILE64
     #define stat stat64
@@ -18,61 +25,163 @@
     #define readdir readdir64
 #endif
 
-static bool isPhysicalDevice(const struct mntent* device)
+// One line of /proc/self/mountinfo. All strings point into the (modified in place) file buffer
+// https://www.kernel.org/doc/html/latest/filesystems/proc.html#proc-pid-mountinfo-information-about-mounts
+typedef struct FFMountEntry
+{
+    uint32_t major;
+    uint32_t minor;
+    const char* mountpoint;
+    const char* options; // Per-mount options
+    const char* fstype;
+    const char* source;
+    const char* superOptions; // Per-superblock options
+} FFMountEntry;
+
+// Decodes octal escapes (`\040` for space, etc) in place
+static void unescapeField(char* field)
+{
+    char* out = field;
+    for (const char* in = field; *in; ++in)
+    {
+        if (in[0] == '\\' && in[1] >= '0' && in[1] <= '3' && in[2] >= '0' && in[2] <= '7' && in[3] >= '0' && in[3] <= '7')
+        {
+            *out++ = (char) ((in[1] - '0') << 6 | (in[2] - '0') << 3 | (in[3] - '0'));
+            in += 3;
+        }
+        else
+            *out++ = *in;
+    }
+    *out = '\0';
+}
+
+// Splits the next space separated field off `*cursor`
+static char* nextField(char** cursor)
+{
+    char* field = *cursor;
+    if (*field == '\0')
+        return NULL;
+    char* end = strchr(field, ' ');
+    if (end)
+    {
+        *end = '\0';
+        *cursor = end + 1;
+    }
+    else
+        *cursor = field + strlen(field);
+    return field;
+}
+
+static bool parseMountEntry(char* line, FFMountEntry* entry)
+{
+    char* cursor = line;
+    char* fields[6];
+    for (uint32_t i = 0; i < ARRAY_SIZE(fields); ++i)
+    {
+        if (!(fields[i] = nextField(&cursor)))
+            return false;
+    }
+
+    // Skip optional fields, terminated by a single hyphen
+    char* field;
+    while ((field = nextField(&cursor)) && !ffStrEquals(field, "-"));
+    if (!field)
+        return false;
+
+    char* fstype = nextField(&cursor);
+    char* source = nextField(&cursor);
+    char* superOptions = nextField(&cursor);
+    if (!superOptions)
+        return false;
+
+    char* minor = strchr(fields[2], ':');
+    if (!minor)
+        return false;
+    entry->major = (uint32_t) strtoul(fields[2], NULL, 10);
+    entry->minor = (uint32_t) strtoul(minor + 1, NULL, 10);
+
+    unescapeField(fields[4]);
+    unescapeField(source);
+    entry->mountpoint = fields[4];
+    entry->options = fields[5];
+    entry->fstype = fstype;
+    entry->source = source;
+    entry->superOptions = superOptions;
+    return true;
+}
+
+static bool hasMountOption(const char* options, const char* option)
+{
+    size_t len = strlen(option);
+    for (const char* p = options; p; p = strchr(p, ','))
+    {
+        if (*p == ',') ++p;
+        if (strncmp(p, option, len) == 0 && (p[len] == ',' || p[len] == '\0'))
+            return true;
+    }
+    return false;
+}
+
+static bool isPhysicalDevice(const FFMountEntry* device)
 {
     #ifndef __ANDROID__ //On Android, `/dev` is not accessible, so that the following checks always fail
 
     //Always show the root path
-    if(ffStrEquals(device->mnt_dir, "/"))
+    if(ffStrEquals(device->mountpoint, "/"))
         return true;
 
-    if(ffStrEquals(device->mnt_fsname, "none"))
+    if(ffStrEquals(device->source, "none"))
         return false;
 
     //DrvFs is a filesystem plugin to WSL that was designed to support interop between WSL and the Windows filesystem.
-    if(ffStrEquals(device->mnt_type, "9p"))
-        return ffStrContains(device->mnt_opts, "aname=drvfs");
+    if(ffStrEquals(device->fstype, "9p"))
+        return ffStrContains(device->superOptions, "aname=drvfs");
 
     //ZFS pool
-    if(ffStrEquals(device->mnt_type, "zfs"))
+    if(ffStrEquals(device->fstype, "zfs"))
         return true;
 
     //Pseudo filesystems don't have a device in /dev
-    if(!ffStrStartsWith(device->mnt_fsname, "/dev/"))
+    if(!ffStrStartsWith(device->source, "/dev/"))
         return false;
 
     //#731
-    if(ffStrEquals(device->mnt_type, "bcachefs"))
+    if(ffStrEquals(device->fstype, "bcachefs"))
         return true;
 
     if(
-        ffStrStartsWith(device->mnt_fsname + 5, "loop") || //Ignore loop devices
-        ffStrStartsWith(device->mnt_fsname + 5, "ram")  || //Ignore ram devices
-        ffStrStartsWith(device->mnt_fsname + 5, "fd")      //Ignore fd devices
+        ffStrStartsWith(device->source + 5, "loop") || //Ignore loop devices
+        ffStrStartsWith(device->source + 5, "ram")  || //Ignore ram devices
+        ffStrStartsWith(device->source + 5, "fd")      //Ignore fd devices
     ) return false;
 
-    struct stat deviceStat;
-    if(stat(device->mnt_fsname, &deviceStat) != 0)
-        return false;
+    //The device number of a superblock backed by a block device is the one of the device itself.
+    //Btrfs (and some others) use anonymous device numbers (major 0) instead, which need an explicit check
+    if(device->major == 0)
+    {
+        struct stat deviceStat;
+        if(stat(device->source, &deviceStat) != 0)
+            return false;
 
-    //Ignore all devices that are not block devices
-    if(!S_ISBLK(deviceStat.st_mode))
-        return false;
+        //Ignore all devices that are not block devices
+        if(!S_ISBLK(deviceStat.st_mode))
+            return false;
+    }
 
     #else
 
     //Pseudo filesystems don't have a device in /dev
-    if(!ffStrStartsWith(device->mnt_fsname, "/dev/"))
+    if(!ffStrStartsWith(device->source, "/dev/"))
         return false;
 
     if(
-        ffStrStartsWith(device->mnt_fsname + 5, "loop") || //Ignore loop devices
-        ffStrStartsWith(device->mnt_fsname + 5, "ram")  || //Ignore ram devices
-        ffStrStartsWith(device->mnt_fsname + 5, "fd")      //Ignore fd devices
+        ffStrStartsWith(device->source + 5, "loop") || //Ignore loop devices
+        ffStrStartsWith(device->source + 5, "ram")  || //Ignore ram devices
+        ffStrStartsWith(device->source + 5, "fd")      //Ignore fd devices
     ) return false;
 
     // https://source.android.com/docs/core/ota/apex?hl=zh-cn
-    if(ffStrStartsWith(device->mnt_dir, "/apex/"))
+    if(ffStrStartsWith(device->mountpoint, "/apex/"))
         return false;
 
     #endif // __ANDROID__
@@ -80,52 +189,92 @@ static bool isPhysicalDevice(const struct mntent* device)
     return true;
 }
 
-static void detectNameFromPath(FFDisk* disk, const struct stat* deviceStat, FFstrbuf* basePath)
+// Resolves the sysfs directory of the block device, e.g. /sys/dev/block/../../devices/pci0000:00/0000:00:14.0/usb4/4-3/4-3:1.0/host0/target0:0:0/0:0:0:0/block/sda/sda1
+static bool getSysBlockPath(const FFMountEntry* device, FFstrbuf* result)
 {
-    FF_AUTO_CLOSE_DIR DIR* dir = opendir(basePath->chars);
+    if (device->major != 0)
+    {
+        char sysDevBlock[64];
+        snprintf(sysDevBlock, ARRAY_SIZE(sysDevBlock), "/sys/dev/block/%u:%u", device->major, device->minor);
+
+        ffStrbufSetS(result, "/sys/dev/block/");
+        ffStrbufEnsureFree(result, PATH_MAX);
+        ssize_t len = readlink(sysDevBlock, result->chars + result->length, ffStrbufGetFree(result));
+        if (len <= 0)
+            return false;
+        result->length += (uint32_t) len;
+        result->chars[result->length] = '\0';
+        return true;
+    }
+
+    if (!ffStrStartsWith(device->source, "/dev/"))
+        return false;
+
+    char devPath[PATH_MAX];
+    if (realpath(device->source, devPath) == NULL)
+        return false;
+
+    char sysClassBlock[PATH_MAX];
+    snprintf(sysClassBlock, ARRAY_SIZE(sysClassBlock), "/sys/class/block/%s", strrchr(devPath, '/') + 1);
+
+    ffStrbufEnsureFree(result, PATH_MAX);
+    if (realpath(sysClassBlock, result->chars) == NULL)
+        return false;
+    ffStrbufRecalculateLength(result);
+    return true;
+}
+
+typedef struct FFDiskLabel
+{
+    FFstrbuf devName; // Kernel name, e.g. sda1
+    FFstrbuf label;
+} FFDiskLabel;
+
+static void loadLabelsFromPath(FFlist* labels, const char* basePath)
+{
+    FF_AUTO_CLOSE_DIR DIR* dir = opendir(basePath);
     if(dir == NULL)
         return;
 
-    uint32_t basePathLength = basePath->length;
-
     struct dirent* entry;
     while((entry = readdir(dir)) != NULL)
     {
         if(entry->d_name[0] == '.')
             continue;
 
-        ffStrbufAppendS(basePath, entry->d_name);
-
-        struct stat entryStat;
-        bool ret = stat(basePath->chars, &entryStat) == 0;
-
-        ffStrbufSubstrBefore(basePath, basePathLength);
-
-        if(!ret || deviceStat->st_ino != entryStat.st_ino)
+        char target[PATH_MAX]; // ../../sda1
+        ssize_t len = readlinkat(dirfd(dir), entry->d_name, target, ARRAY_SIZE(target) - 1);
+        if (len <= 0)
             continue;
+        target[len] = '\0';
 
-        ffStrbufAppendS(&disk->name, entry->d_name);
-        break;
+        FFDiskLabel* label = ffListAdd(labels);
+        const char* slash = strrchr(target, '/');
+        ffStrbufInitS(&label->devName, slash ? slash + 1 : target);
+        ffStrbufInitS(&label->label, entry->d_name);
     }
 }
 
-static void detectName(FFDisk* disk)
+// Label first, partlabel second
+static void loadLabels(FFlist* labels)
 {
-    struct stat deviceStat;
-    if(stat(disk->mountFrom.chars, &deviceStat) != 0)
-        return;
-
-    FF_STRBUF_AUTO_DESTROY basePath = ffStrbufCreate();
+    loadLabelsFromPath(labels, "/dev/disk/by-label/");
+    loadLabelsFromPath(labels, "/dev/disk/by-partlabel/");
+}
 
-    //Try label first
-    ffStrbufSetS(&basePath, "/dev/disk/by-label/");
-    detectNameFromPath(disk, &deviceStat, &basePath);
+static void detectName(FFDisk* disk, const FFstrbuf* sysBlockPath, const FFlist* labels)
+{
+    const char* devName = memrchr(sysBlockPath->chars, '/', sysBlockPath->length);
+    if (!devName) return;
+    ++devName;
 
-    if(disk->name.length == 0)
+    FF_LIST_FOR_EACH(FFDiskLabel, label, *labels)
     {
-        //Try partlabel second
-        ffStrbufSetS(&basePath, "/dev/disk/by-partlabel/");
-        detectNameFromPath(disk, &deviceStat, &basePath);
+        if (ffStrbufEqualS(&label->devName, devName))
+        {
+            ffStrbufSet(&disk->name, &label->label);
+            break;
+        }
     }
 
     if (disk->name.length == 0) return;
@@ -149,7 +298,7 @@ static void detectName(FFDisk* disk)
 
 #ifdef __ANDROID__
 
-static void detectType(FF_MAYBE_UNUSED const FFlist* disks, FFDisk* currentDisk, FF_MAYBE_UNUSED struct mntent* device)
+static void detectType(FF_MAYBE_UNUSED const FFlist* disks, FFDisk* currentDisk, FF_MAYBE_UNUSED const FFMountEntry* device, FF_MAYBE_UNUSED const FFstrbuf* sysBlockPath)
 {
     if(ffStrbufEqualS(&currentDisk->mountpoint, "/") || ffStrbufEqualS(&currentDisk->mountpoint, "/storage/emulated"))
         currentDisk->type = FF_DISK_VOLUME_TYPE_REGULAR_BIT;
@@ -198,54 +347,70 @@ static bool isSubvolume(const FFlist* disks, FFDisk* currentDisk)
     return false;
 }
 
-static bool isRemovable(FFDisk* currentDisk)
+static bool isRemovable(const FFstrbuf* sysBlockPath)
 {
-    if (!ffStrbufStartsWithS(&currentDisk->mountFrom, "/dev/"))
+    if (sysBlockPath->length == 0)
         return false;
 
-    char sysBlockPartition[64];
-    snprintf(sysBlockPartition, ARRAY_SIZE(sysBlockPartition), "/sys/class/block/%s", currentDisk->mountFrom.chars + strlen("/dev/"));
-
-    char sysBlockVolume[PATH_MAX]; // /sys/devices/pci0000:00/0000:00:14.0/usb4/4-3/4-3:1.0/host0/target0:0:0/0:0:0:0/block/sda/sda1
-    if (realpath(sysBlockPartition, sysBlockVolume) == NULL)
-        return false;
-    strcpy(strrchr(sysBlockVolume, '/') + 1, "removable");
+    // /sys/.../block/sda/sda1 => /sys/.../block/sda/removable
+    char removablePath[PATH_MAX];
+    const char* slash = memrchr(sysBlockPath->chars, '/', sysBlockPath->length);
+    if (!slash) return false;
+    snprintf(removablePath, ARRAY_SIZE(removablePath), "%.*s/removable", (int) (slash - sysBlockPath->chars), sysBlockPath->chars);
 
     char removableChar = '0';
-    return ffReadFileData(sysBlockVolume, 1, &removableChar) > 0 && removableChar == '1';
+    return ffReadFileData(removablePath, 1, &removableChar) > 0 && removableChar == '1';
 }
 
-static void detectType(const FFlist* disks, FFDisk* currentDisk, struct mntent* device)
+static void detectType(const FFlist* disks, FFDisk* currentDisk, const FFMountEntry* device, const FFstrbuf* sysBlockPath)
 {
     if(ffStrbufStartsWithS(&currentDisk->mountpoint, "/boot") || ffStrbufStartsWithS(&currentDisk->mountpoint, "/efi"))
         currentDisk->type = FF_DISK_VOLUME_TYPE_HIDDEN_BIT;
     else if(isSubvolume(disks, currentDisk))
         currentDisk->type = FF_DISK_VOLUME_TYPE_SUBVOLUME_BIT;
-    else if(isRemovable(currentDisk))
+    else if(isRemovable(sysBlockPath))
         currentDisk->type = FF_DISK_VOLUME_TYPE_EXTERNAL_BIT;
     else
         currentDisk->type = FF_DISK_VOLUME_TYPE_REGULAR_BIT;
-    if (hasmntopt(device, MNTOPT_RO))
+    // The superblock is read-only too if the kernel remounted it after errors (errors=remount-ro)
+    if (hasMountOption(device->options, "ro") || hasMountOption(device->superOptions, "ro"))
         currentDisk->type |= FF_DISK_VOLUME_TYPE_READONLY_BIT;
 }
 
 #endif
 
-static void detectStats(FFDisk* disk)
+typedef struct FFDiskStats
 {
     struct statvfs fs;
-    if(statvfs(disk->mountpoint.chars, &fs) != 0)
-        memset(&fs, 0, sizeof(fs)); //Set all values to 0, so our values get initialized to 0 too
+    uint64_t createTime;
+} FFDiskStats;
 
-    disk->bytesTotal = fs.f_blocks * fs.f_frsize;
-    disk->bytesFree = fs.f_bfree * fs.f_frsize;
-    disk->bytesAvailable = fs.f_bavail * fs.f_frsize;
+static void queryStats(const char* mountpoint, FFDiskStats* stats)
+{
+    if(statvfs(mountpoint, &stats->fs) != 0)
+        memset(&stats->fs, 0, sizeof(stats->fs)); //Set all values to 0, so our values get initialized to 0 too
+
+    stats->createTime = 0;
+    #ifdef FF_HAVE_STATX
+    struct statx stx;
+    if (statx(0, mountpoint, 0, STATX_BTIME, &stx) == 0 && (stx.stx_mask & STATX_BTIME))
+        stats->createTime = (uint64_t)((stx.stx_btime.tv_sec * 1000) + (stx.stx_btime.tv_nsec / 1000000));
+    #endif
+}
+
+static void detectStats(FFDisk* disk, const FFDiskStats* stats)
+{
+    const struct statvfs* fs = &stats->fs;
+
+    disk->bytesTotal = fs->f_blocks * fs->f_frsize;
+    disk->bytesFree = fs->f_bfree * fs->f_frsize;
+    disk->bytesAvailable = fs->f_bavail * fs->f_frsize;
     disk->bytesUsed = 0; // To be filled in ./disk.c
 
-    if (fs.f_files >= fs.f_ffree)
+    if (fs->f_files >= fs->f_ffree)
     {
-        disk->filesTotal = (uint32_t) fs.f_files;
-        disk->filesUsed = (uint32_t) (disk->filesTotal - fs.f_ffree);
+        disk->filesTotal = (uint32_t) fs->f_files;
+        disk->filesUsed = (uint32_t) (disk->filesTotal - fs->f_ffree);
     }
     else
     {
@@ -253,62 +418,409 @@ static void detectStats(FFDisk* disk)
         disk->filesTotal = disk->filesUsed = 0;
     }
 
-    disk->createTime = 0;
-    #ifdef FF_HAVE_STATX
-    struct statx stx;
-    if (statx(0, disk->mountpoint.chars, 0, STATX_BTIME, &stx) == 0 && (stx.stx_mask & STATX_BTIME))
-        disk->createTime = (uint64_t)((stx.stx_btime.tv_sec * 1000) + (stx.stx_btime.tv_nsec / 1000000));
-    #endif
+    disk->createTime = stats->createTime;
 
     #ifdef __ANDROID__ // hasmntopt requires a higher Android API level
-    if(fs.f_flag & ST_RDONLY)
+    if(fs->f_flag & ST_RDONLY)
         disk->type |= FF_DISK_VOLUME_TYPE_READONLY_BIT;
     #endif
 }
 
-const char* ffDetectDisksImpl(FFDiskOptions* options, FFlist* disks)
+#ifdef FF_HAVE_THREADS
+
+// A hung NFS / CIFS / FUSE mount blocks statvfs (nearly) forever, and the blocked thread can't be cancelled.
+// Workers are detached; the batch is freed by whoever drops the last reference, so that late workers never touch freed memory.
+typedef struct FFDiskStatsBatch FFDiskStatsBatch;
+
+typedef struct FFDiskStatsTask
 {
-    FILE* mountsFile = setmntent("/proc/mounts", "r");
-    if(mountsFile == NULL)
-        return "setmntent(\"/proc/mounts\", \"r\") == NULL";
+    FFDiskStatsBatch* batch;
+    char* mountpoint;
+    FFDiskStats stats;
+    bool done;
+} FFDiskStatsTask;
 
-    struct mntent* device;
+struct FFDiskStatsBatch
+{
+    uint32_t refs;
+    uint32_t count;
+    int pipes[2]; // Workers write one byte when done
+    FFDiskStatsTask tasks[];
+};
+
+static void releaseStatsBatch(FFDiskStatsBatch* batch)
+{
+    if (__atomic_sub_fetch(&batch->refs, 1, __ATOMIC_ACQ_REL) > 0)
+        return;
+
+    close(batch->pipes[0]);
+    close(batch->pipes[1]);
+    for (uint32_t i = 0; i < batch->count; ++i)
+        free(batch->tasks[i].mountpoint);
+    free(batch);
+}
 
-    while((device = getmntent(mountsFile)))
+static void statsWorker(FFDiskStatsTask* task)
+{
+    FFDiskStatsBatch* batch = task->batch;
+    queryStats(task->mountpoint, &task->stats);
+    __atomic_store_n(&task->done, true, __ATOMIC_RELEASE);
+    FF_UNUSED(write(batch->pipes[1], "", 1));
+    releaseStatsBatch(batch);
+}
+
+FF_THREAD_ENTRY_DECL_WRAPPER(statsWorker, FFDiskStatsTask*)
+
+static bool detectAllStatsAsync(FFlist* disks, uint32_t timeout)
+{
+    FFDiskStatsBatch* batch = calloc(1, sizeof(*batch) + disks->length * sizeof(FFDiskStatsTask));
+    if (pipe2(batch->pipes, O_CLOEXEC | O_NONBLOCK) != 0)
     {
-        if (__builtin_expect(options->folders.length, 0))
+        free(batch);
+        return false;
+    }
+    batch->refs = 1; // Ours
+    batch->count = disks->length;
+
+    for (uint32_t i = 0; i < disks->length; ++i)
+    {
+        FFDiskStatsTask* task = &batch->tasks[i];
+        task->batch = batch;
+        task->mountpoint = strdup(FF_LIST_GET(FFDisk, *disks, i)->mountpoint.chars);
+
+        __atomic_add_fetch(&batch->refs, 1, __ATOMIC_RELAXED);
+        FFThreadType thread = ffThreadCreate(statsWorkerThreadMain, task);
+        if (thread)
+            ffThreadDetach(thread);
+        else
         {
-            if (!ffDiskMatchMountpoint(options, device->mnt_dir))
-                continue;
+            __atomic_sub_fetch(&batch->refs, 1, __ATOMIC_RELAXED);
+            queryStats(task->mountpoint, &task->stats);
+            task->done = true;
         }
-        else if(!isPhysicalDevice(device))
-            continue;
+    }
+
+    double deadline = ffTimeGetTick() + timeout;
+    while (true)
+    {
+        uint32_t pending = 0;
+        for (uint32_t i = 0; i < batch->count; ++i)
+            pending += !__atomic_load_n(&batch->tasks[i].done, __ATOMIC_ACQUIRE);
+        if (pending == 0)
+            break;
+
+        double remaining = deadline - ffTimeGetTick();
+        if (remaining <= 0)
+            break;
+
+        struct pollfd pfd = { .fd = batch->pipes[0], .events = POLLIN };
+        if (poll(&pfd, 1, (int) remaining + 1) > 0)
+        {
+            char buf[32];
+            while (read(batch->pipes[0], buf, sizeof(buf)) > 0);
+        }
+    }
+
+    for (uint32_t i = 0; i < batch->count; ++i)
+    {
+        FFDiskStatsTask* task = &batch->tasks[i];
+        FFDisk* disk = FF_LIST_GET(FFDisk, *disks, i);
+        if (__atomic_load_n(&task->done, __ATOMIC_ACQUIRE))
+            detectStats(disk, &task->stats);
+        else
+        {
+            FF_DEBUG("statvfs(\"%s\") timed out after %u ms", task->mountpoint, timeout);
+            detectStats(disk, &(FFDiskStats) {});
+            disk->type |= FF_DISK_VOLUME_TYPE_UNAVAILABLE_BIT;
+        }
+    }
+
+    releaseStatsBatch(batch);
+    return true;
+}
+
+#endif
+
+static void detectAllStats(FFDiskOptions* options, FFlist* disks)
+{
+    #ifdef FF_HAVE_THREADS
+    if (options->timeout > 0 && disks->length > 0 && detectAllStatsAsync(disks, options->timeout))
+        return;
+    #else
+    FF_UNUSED(options);
+    #endif
+
+    FF_LIST_FOR_EACH(FFDisk, disk, *disks)
+    {
+        FFDiskStats stats;
+        queryStats(disk->mountpoint.chars, &stats);
+        detectStats(disk, &stats);
+    }
+}
+
+typedef struct FFDiskScanContext
+{
+    FFlist labels; // List of FFDiskLabel, loaded lazily
+    bool labelsLoaded;
+    FFstrbuf sysBlockPath;
+} FFDiskScanContext;
+
+static void addDisk(FFDiskOptions* options, FFlist* disks, const FFMountEntry* device, FFDiskScanContext* ctx)
+{
+    if (__builtin_expect(options->folders.length, 0))
+    {
+        if (!ffDiskMatchMountpoint(options, device->mountpoint))
+            return;
+    }
+    else if(!isPhysicalDevice(device))
+        return;
+
+    //We have a valid device, add it to the list
+    FFDisk* disk = ffListAdd(disks);
+    disk->type = FF_DISK_VOLUME_TYPE_NONE;
+
+    //detect mountFrom
+    ffStrbufInitS(&disk->mountFrom, device->source);
+
+    //detect mountpoint
+    ffStrbufInitS(&disk->mountpoint, device->mountpoint);
+
+    //detect filesystem
+    ffStrbufInitS(&disk->filesystem, device->fstype);
+
+    if (!getSysBlockPath(device, &ctx->sysBlockPath))
+        ffStrbufClear(&ctx->sysBlockPath);
+
+    //detect name
+    ffStrbufInit(&disk->name);
+    if (ctx->sysBlockPath.length > 0)
+    {
+        if (!ctx->labelsLoaded)
+        {
+            loadLabels(&ctx->labels);
+            ctx->labelsLoaded = true;
+        }
+        detectName(disk, &ctx->sysBlockPath, &ctx->labels);
+    }
 
-        //We have a valid device, add it to the list
-        FFDisk* disk = ffListAdd(disks);
-        disk->type = FF_DISK_VOLUME_TYPE_NONE;
+    //detect type
+    detectType(disks, disk, device, &ctx->sysBlockPath);
+}
+
+static const char* detectDisksMountinfo(FFDiskOptions* options, FFlist* disks, FFDiskScanContext* ctx)
+{
+    // Read at once and parse in place; container hosts can have thousands of mounts
+    FF_STRBUF_AUTO_DESTROY mountinfo = ffStrbufCreate();
+    if(!ffReadFileBuffer("/proc/self/mountinfo", &mountinfo))
+        return "ffReadFileBuffer(\"/proc/self/mountinfo\") failed";
+
+    for (char* line = mountinfo.chars; *line; )
+    {
+        char* lineEnd = strchr(line, '\n');
+        if (lineEnd)
+            *lineEnd = '\0';
+        char* nextLine = lineEnd ? lineEnd + 1 : line + strlen(line);
+
+        FFMountEntry device;
+        if (parseMountEntry(line, &device))
+            addDisk(options, disks, &device, ctx);
+        line = nextLine;
+    }
 
-        //detect mountFrom
-        ffStrbufInitS(&disk->mountFrom, device->mnt_fsname);
+    return NULL;
+}
+
+#if !__ANDROID__ // Unknown syscalls are fatal under Android's seccomp policy
 
-        //detect mountpoint
-        ffStrbufInitS(&disk->mountpoint, device->mnt_dir);
+#ifndef __NR_statmount
+    #ifndef __alpha__ // Same numbers on all other architectures since Linux 6.8
+        #define __NR_statmount 457
+        #define __NR_listmount 458
+    #endif
+#endif
 
-        //detect filesystem
-        ffStrbufInitS(&disk->filesystem, device->mnt_type);
+#endif
 
-        //detect name
-        ffStrbufInit(&disk->name);
-        detectName(disk); // Also detects external devices
+#ifdef __NR_statmount
+
+// Uapi definitions of <linux/mount.h> (Linux 6.8+). Not all libc headers ship them yet
+#define FF_LSMT_ROOT 0xffffffffffffffffULL
+#define FF_MNT_ID_REQ_SIZE_VER0 24
+#define FF_STATMOUNT_SB_BASIC 0x00000001U
+#define FF_STATMOUNT_MNT_BASIC 0x00000002U
+#define FF_STATMOUNT_MNT_POINT 0x00000010U
+#define FF_STATMOUNT_FS_TYPE 0x00000020U
+#define FF_STATMOUNT_MNT_OPTS 0x00000080U // Linux 6.11
+#define FF_STATMOUNT_SB_SOURCE 0x00000200U // Linux 6.13
+#define FF_MOUNT_ATTR_RDONLY 0x00000001U
+#define FF_SB_RDONLY 0x00000001U
+
+typedef struct FFMntIdReq
+{
+    uint32_t size;
+    uint32_t spare;
+    uint64_t mntId;
+    uint64_t param;
+} FFMntIdReq;
+
+// Strings are offsets into `str`, which always starts at byte 512
+typedef struct FFStatmount
+{
+    uint32_t size;
+    uint32_t mntOpts;
+    uint64_t mask;
+    uint32_t sbDevMajor;
+    uint32_t sbDevMinor;
+    uint64_t sbMagic;
+    uint32_t sbFlags;
+    uint32_t fsType;
+    uint64_t mntId;
+    uint64_t mntParentId;
+    uint32_t mntIdOld;
+    uint32_t mntParentIdOld;
+    uint64_t mntAttr;
+    uint64_t mntPropagation;
+    uint64_t mntPeerGroup;
+    uint64_t mntMaster;
+    uint64_t propagateFrom;
+    uint32_t mntRoot;
+    uint32_t mntPoint;
+    uint64_t mntNsId;
+    uint32_t fsSubtype;
+    uint32_t sbSource;
+    uint8_t spare[384];
+    char str[];
+} FFStatmount;
+static_assert(sizeof(FFStatmount) == 512, "Unexpected struct FFStatmount layout");
+
+// Only what is needed to select and classify disks; superblock options are fetched on demand (9p only)
+#define FF_STATMOUNT_MASK (FF_STATMOUNT_SB_BASIC | FF_STATMOUNT_MNT_BASIC | FF_STATMOUNT_MNT_POINT | FF_STATMOUNT_FS_TYPE | FF_STATMOUNT_SB_SOURCE)
+
+static bool statmountById(uint64_t mntId, uint64_t mask, FFstrbuf* buffer)
+{
+    FFMntIdReq req = {
+        .size = FF_MNT_ID_REQ_SIZE_VER0,
+        .mntId = mntId,
+        .param = mask,
+    };
 
-        //detect type
-        detectType(disks, disk, device);
+    while (true)
+    {
+        if (syscall(__NR_statmount, &req, buffer->chars, (size_t) buffer->allocated, 0) == 0)
+            return true;
+        if (errno != EOVERFLOW || buffer->allocated >= 1024 * 1024)
+            return false;
+        ffStrbufEnsureFree(buffer, buffer->allocated * 2);
+    }
+}
 
-        //Detects stats
-        detectStats(disk);
+// Returns false if listmount / statmount (with the fields we need) is not supported; nothing is added then
+static bool detectDisksStatmount(FFDiskOptions* options, FFlist* disks, FFDiskScanContext* ctx)
+{
+    FF_AUTO_FREE uint64_t* ids = NULL;
+    uint32_t idCount = 0;
+    FFMntIdReq req = {
+        .size = FF_MNT_ID_REQ_SIZE_VER0,
+        .mntId = FF_LSMT_ROOT,
+        .param = 0, // Continue after this mount id
+    };
+
+    while (true)
+    {
+        const uint32_t batch = 512;
+        ids = realloc(ids, (idCount + batch) * sizeof(*ids));
+        long count = syscall(__NR_listmount, &req, ids + idCount, (size_t) batch, 0);
+        if (count < 0)
+        {
+            FF_DEBUG("listmount() failed: %s", strerror(errno));
+            return false;
+        }
+        idCount += (uint32_t) count;
+        if (count < batch)
+            break;
+        req.param = ids[idCount - 1];
     }
 
-    endmntent(mountsFile);
+    FF_STRBUF_AUTO_DESTROY buffer = ffStrbufCreateA(4096);
+    FF_STRBUF_AUTO_DESTROY superOptions = ffStrbufCreateA(4096);
+    bool probed = false;
+
+    for (uint32_t i = 0; i < idCount; ++i)
+    {
+        if (!statmountById(ids[i], FF_STATMOUNT_MASK, &buffer))
+        {
+            if (!probed)
+            {
+                FF_DEBUG("statmount() failed: %s", strerror(errno));
+                return false;
+            }
+            continue; // Unmounted meanwhile
+        }
+
+        const FFStatmount* sm = (const FFStatmount*) buffer.chars;
+        if ((sm->mask & FF_STATMOUNT_MASK) != FF_STATMOUNT_MASK)
+        {
+            if (!probed)
+            {
+                FF_DEBUG("statmount() lacks required fields (mask 0x%llx)", (unsigned long long) sm->mask);
+                return false;
+            }
+            continue; // E.g. no mount point for mounts outside of our root; the string offsets would be 0
+        }
+        probed = true;
+
+        FFMountEntry device = {
+            .major = sm->sbDevMajor,
+            .minor = sm->sbDevMinor,
+            .mountpoint = sm->str + sm->mntPoint,
+            // The superblock is read-only too if the kernel remounted it after errors (errors=remount-ro)
+            .options = (sm->mntAttr & FF_MOUNT_ATTR_RDONLY) || (sm->sbFlags & FF_SB_RDONLY) ? "ro" : "rw",
+            .fstype = sm->str + sm->fsType,
+            .source = sm->str + sm->sbSource,
+            .superOptions = "",
+        };
+
+        if (ffStrEquals(device.fstype, "9p") && statmountById(ids[i], FF_STATMOUNT_MNT_OPTS, &superOptions))
+        {
+            const FFStatmount* smOpts = (const FFStatmount*) superOptions.chars;
+            if (smOpts->mask & FF_STATMOUNT_MNT_OPTS)
+                device.superOptions = smOpts->str + smOpts->mntOpts;
+        }
+
+        addDisk(options, disks, &device, ctx);
+    }
+
+    return probed;
+}
+
+#endif // __NR_statmount
+
+const char* ffDetectDisksImpl(FFDiskOptions* options, FFlist* disks)
+{
+    FFDiskScanContext ctx = {
+        .labels = ffListCreate(sizeof(FFDiskLabel)),
+        .sysBlockPath = ffStrbufCreate(),
+    };
+
+    const char* error = NULL;
+    #ifdef __NR_statmount
+    if (!detectDisksStatmount(options, disks, &ctx))
+    #endif
+        error = detectDisksMountinfo(options, disks, &ctx);
+
+    FF_LIST_FOR_EACH(FFDiskLabel, label, ctx.labels)
+    {
+        ffStrbufDestroy(&label->devName);
+        ffStrbufDestroy(&label->label);
+    }
+    ffListDestroy(&ctx.labels);
+    ffStrbufDestroy(&ctx.sysBlockPath);
+
+    if (error)
+        return error;
+
+    //Detects stats. Done for all disks at once, so that unresponsive mounts can be timed out
+    detectAllStats(options, disks);
 
     return NULL;
 }
@@ -1,12 +1,92 @@
 #include "diskio.h"
 
 #include "common/time.h"
+#include "common/snapshot.h"
+#include "util/mallocHelper.h"
 
 const char* ffDiskIOGetIoCounters(FFlist* result, FFDiskIOOptions* options);
 
 static FFlist ioCounters1;
 static uint64_t time1;
 
+static void destroyCounters(FFlist* counters)
+{
+    FF_LIST_FOR_EACH(FFDiskIOResult, dev, *counters)
+    {
+        ffStrbufDestroy(&dev->name);
+        ffStrbufDestroy(&dev->devPath);
+    }
+    ffListDestroy(counters);
+}
+
+static const char* checkSameDevices(const FFlist* prev, const FFlist* curr)
+{
+    if (curr->length != prev->length)
+        return "Different number of physical disks. Hardware change?";
+
+    for (uint32_t i = 0; i < curr->length; ++i)
+    {
+        if (!ffStrbufEqual(&FF_LIST_GET(FFDiskIOResult, *prev, i)->devPath, &FF_LIST_GET(FFDiskIOResult, *curr, i)->devPath))
+            return "Physical disk device path changed";
+    }
+    return NULL;
+}
+
+static const size_t snapshotCounters[] = {
+    offsetof(FFDiskIOResult, bytesRead),
+    offsetof(FFDiskIOResult, readCount),
+    offsetof(FFDiskIOResult, bytesWritten),
+    offsetof(FFDiskIOResult, writeCount),
+    offsetof(FFDiskIOResult, bytesDiscarded),
+    offsetof(FFDiskIOResult, discardCount),
+    offsetof(FFDiskIOResult, flushCount),
+    offsetof(FFDiskIOResult, readTime),
+    offsetof(FFDiskIOResult, writeTime),
+    offsetof(FFDiskIOResult, discardTime),
+    offsetof(FFDiskIOResult, flushTime),
+    offsetof(FFDiskIOResult, ioTime),
+    offsetof(FFDiskIOResult, queueTime),
+};
+
+// Use the counters saved by the previous run as the first sample, if they are recent enough
+static void loadSnapshot(FFDiskIOOptions* options)
+{
+    FF_STRBUF_AUTO_DESTROY name = ffStrbufCreate();
+    ffSnapshotGetName("diskio", &options->namePrefix, &name);
+    FF_STRBUF_AUTO_DESTROY content = ffStrbufCreate();
+    uint64_t time;
+    if (!ffSnapshotLoad(name.chars, options->snapshotMaxAge, &content, &time) || time >= time1)
+        return;
+
+    FF_AUTO_FREE FFDiskIOResult* counters = malloc(ioCounters1.length * sizeof(*counters));
+    for (uint32_t i = 0; i < ioCounters1.length; ++i)
+    {
+        const FFDiskIOResult* current = FF_LIST_GET(FFDiskIOResult, ioCounters1, i);
+        counters[i] = *current;
+        if (!ffSnapshotFindCounters(&content, &counters[i].devPath, &counters[i], snapshotCounters, ARRAY_SIZE(snapshotCounters)))
+            return; // Disks changed
+
+        for (uint32_t j = 0; j < ARRAY_SIZE(snapshotCounters); ++j)
+        {
+            if (*(uint64_t*) ((uint8_t*) &counters[i] + snapshotCounters[j]) > *(const uint64_t*) ((const uint8_t*) current + snapshotCounters[j]))
+                return; // Counters have been reset, e.g. the disk was plugged again
+        }
+    }
+
+    memcpy(ioCounters1.data, counters, ioCounters1.length * sizeof(*counters));
+    time1 = time;
+}
+
+static void saveSnapshot(const FFDiskIOOptions* options, const FFlist* counters, uint64_t time)
+{
+    FF_STRBUF_AUTO_DESTROY name = ffStrbufCreate();
+    ffSnapshotGetName("diskio", &options->namePrefix, &name);
+    FF_STRBUF_AUTO_DESTROY content = ffStrbufCreate();
+    FF_LIST_FOR_EACH(FFDiskIOResult, dev, *counters)
+        ffSnapshotAppendCounters(&content, &dev->devPath, dev, snapshotCounters, ARRAY_SIZE(snapshotCounters));
+    ffSnapshotSave(name.chars, time, &content);
+}
+
 void ffPrepareDiskIO(FFDiskIOOptions* options)
 {
     if (options->detectTotal) return;
@@ -25,6 +105,8 @@ const char* ffDetectDiskIO(FFlist* result, FFDiskIOOptions* options)
         error = ffDiskIOGetIoCounters(result, options);
         if (error)
             return error;
+        if (options->snapshotMaxAge > 0)
+            saveSnapshot(options, result, ffTimeGetNow());
         return NULL;
     }
 
@@ -40,39 +122,118 @@ const char* ffDetectDiskIO(FFlist* result, FFDiskIOOptions* options)
     if (ioCounters1.length == 0)
         return "No physical disk found";
 
-    uint64_t time2 = ffTimeGetNow();
-    while (time2 - time1 < options->waitTime)
+    if (options->snapshotMaxAge > 0)
+        loadSnapshot(options);
+
+    // The sampling window [time1, time1 + waitTime] is split into `sampleCount` intervals.
+    // Rates are computed over the whole window; each interval only contributes to `utilizationPeak`
+    uint32_t sampleCount = options->sampleCount > 0 ? options->sampleCount : 1;
+    FF_LIST_AUTO_DESTROY peaks = ffListCreate(sizeof(double));
+    for (uint32_t i = 0; i < ioCounters1.length; ++i)
+        *(double*) ffListAdd(&peaks) = 0;
+
+    FFlist prevSample = ffListCreate(sizeof(FFDiskIOResult));
+    uint64_t prevTime = time1;
+    uint64_t time2 = time1;
+    for (uint32_t sample = 1; sample <= sampleCount; ++sample)
     {
-        ffTimeSleep((uint32_t) (options->waitTime - (time2 - time1)));
+        uint64_t target = time1 + (uint64_t) options->waitTime * sample / sampleCount;
         time2 = ffTimeGetNow();
-    }
+        if (time2 >= target && sample < sampleCount)
+            continue; // Already passed (module printed late); merge it into the next interval
+        while (time2 < target)
+        {
+            ffTimeSleep((uint32_t) (target - time2));
+            time2 = ffTimeGetNow();
+        }
+
+        FFlist* currSample = sample == sampleCount ? result : &(FFlist) { .elementSize = sizeof(FFDiskIOResult) };
+        error = ffDiskIOGetIoCounters(currSample, options);
+        if (!error)
+            error = checkSameDevices(&ioCounters1, currSample);
+        if (error)
+        {
+            if (currSample != result) destroyCounters(currSample);
+            break;
+        }
 
-    error = ffDiskIOGetIoCounters(result, options);
+        const FFlist* base = prevSample.length > 0 ? &prevSample : &ioCounters1;
+        if (time2 > prevTime)
+        {
+            for (uint32_t i = 0; i < currSample->length; ++i)
+            {
+                FFDiskIOResult* prev = FF_LIST_GET(FFDiskIOResult, *base, i);
+                FFDiskIOResult* curr = FF_LIST_GET(FFDiskIOResult, *currSample, i);
+                double utilization = (double) (curr->ioTime - prev->ioTime) * 100 / (double) (time2 - prevTime);
+                double* peak = FF_LIST_GET(double, peaks, i);
+                if (utilization > *peak) *peak = utilization;
+            }
+        }
+
+        if (currSample != result)
+        {
+            destroyCounters(&prevSample);
+            prevSample = *currSample;
+        }
+        prevTime = time2;
+    }
+    destroyCounters(&prevSample);
     if (error)
         return error;
 
-    if (result->length != ioCounters1.length)
-        return "Different number of physical disks. Hardware change?";
+    double elapsedMs = (double) (time2 - time1);
+    if (elapsedMs <= 0) elapsedMs = 1;
+    double seconds = elapsedMs / 1000;
 
     for (uint32_t i = 0; i < result->length; ++i)
     {
         FFDiskIOResult* icPrev = FF_LIST_GET(FFDiskIOResult, ioCounters1, i);
         FFDiskIOResult* icCurr = FF_LIST_GET(FFDiskIOResult, *result, i);
-        if (!ffStrbufEqual(&icPrev->devPath, &icCurr->devPath))
-            return "Physical disk device path changed";
+        FFDiskIOResult temp = *icCurr;
+
+        uint64_t reads = icCurr->readCount - icPrev->readCount;
+        uint64_t writes = icCurr->writeCount - icPrev->writeCount;
+
+        icCurr->readTime -= icPrev->readTime;
+        icCurr->writeTime -= icPrev->writeTime;
+        icCurr->discardTime -= icPrev->discardTime;
+        icCurr->flushTime -= icPrev->flushTime;
+        icCurr->ioTime -= icPrev->ioTime;
+        icCurr->queueTime -= icPrev->queueTime;
 
-        static_assert(sizeof(FFDiskIOResult) - offsetof(FFDiskIOResult, bytesRead) == sizeof(uint64_t) * 4, "Unexpected struct FFDiskIOResult layout");
-        for (size_t off = offsetof(FFDiskIOResult, bytesRead); off < sizeof(FFDiskIOResult); off += sizeof(uint64_t))
+        #define FF_DISKIO_RATE(field) icCurr->field = (uint64_t) ((double) (icCurr->field - icPrev->field) / seconds)
+        FF_DISKIO_RATE(bytesRead);
+        FF_DISKIO_RATE(readCount);
+        FF_DISKIO_RATE(bytesWritten);
+        FF_DISKIO_RATE(writeCount);
+        FF_DISKIO_RATE(bytesDiscarded);
+        FF_DISKIO_RATE(discardCount);
+        FF_DISKIO_RATE(flushCount);
+        #undef FF_DISKIO_RATE
+
+        if (icCurr->hasExtendedStats)
         {
-            uint64_t* prevValue = (uint64_t*) ((uint8_t*) icPrev + off);
-            uint64_t* currValue = (uint64_t*) ((uint8_t*) icCurr + off);
-            uint64_t temp = *currValue;
-            *currValue -= *prevValue;
-            *currValue /= (time2 - time1) / 1000 /* seconds */;
-            *prevValue = temp;
+            icCurr->readAwait = reads > 0 ? (double) icCurr->readTime / (double) reads : 0;
+            icCurr->writeAwait = writes > 0 ? (double) icCurr->writeTime / (double) writes : 0;
+            icCurr->utilization = (double) icCurr->ioTime * 100 / elapsedMs;
+            if (icCurr->utilization > 100) icCurr->utilization = 100;
+            icCurr->utilizationPeak = *FF_LIST_GET(double, peaks, i);
+            if (icCurr->utilizationPeak > 100) icCurr->utilizationPeak = 100;
+            if (icCurr->utilizationPeak < icCurr->utilization) icCurr->utilizationPeak = icCurr->utilization;
+            icCurr->queueDepth = (double) icCurr->queueTime / elapsedMs;
         }
+
+        // Keep the raw counters for the next call (multiple DiskIO modules)
+        ffStrbufDestroy(&icPrev->name);
+        ffStrbufDestroy(&icPrev->devPath);
+        *icPrev = temp;
+        ffStrbufInitCopy(&icPrev->name, &temp.name);
+        ffStrbufInitCopy(&icPrev->devPath, &temp.devPath);
     }
     time1 = time2;
 
+    if (options->snapshotMaxAge > 0)
+        saveSnapshot(options, &ioCounters1, time1);
+
     return NULL;
 }
@@ -10,6 +10,28 @@ typedef struct FFDiskIOResult
     uint64_t readCount;
     uint64_t bytesWritten;
     uint64_t writeCount;
+
+    // Extended statistics, only filled when `hasExtendedStats` is set (Linux)
+    // Counters are per second like the fields above; times (in ms) are the time spent during the sampling window
+    // With `detectTotal`, all of them are totals since boot
+    uint64_t bytesDiscarded;
+    uint64_t discardCount;
+    uint64_t flushCount;
+    uint64_t readTime;
+    uint64_t writeTime;
+    uint64_t discardTime;
+    uint64_t flushTime;
+    uint64_t ioTime; // Time the device had I/O in flight
+    uint64_t queueTime; // Weighted by the number of requests in flight
+    uint32_t inFlight; // Requests in flight when the last sample was taken
+
+    // Derived from the extended statistics over the sampling window (like `iostat -x`); 0 with `detectTotal`
+    double readAwait; // Average time (in ms) a read request took, including queueing
+    double writeAwait;
+    double utilization; // Percentage of time the device was busy
+    double utilizationPeak; // Highest utilization among the sampling intervals
+    double queueDepth; // Average number of requests in flight (aqu-sz)
+    bool hasExtendedStats;
 } FFDiskIOResult;
 
 const char* ffDetectDiskIO(FFlist* result, FFDiskIOOptions* options);
@@ -38,6 +38,7 @@ const char* ffDiskIOGetIoCounters(FFlist* result, FFDiskIOOptions* options)
             continue;
 
         FFDiskIOResult* device = (FFDiskIOResult*) ffListAdd(result);
+        *device = (FFDiskIOResult) {};
         ffStrbufInitS(&device->name, deviceName);
         ffStrbufInit(&device->devPath);
 
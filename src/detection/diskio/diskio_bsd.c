@@ -48,6 +48,7 @@ const char* ffDiskIOGetIoCounters(FFlist* result, FFDiskIOOptions* options)
             continue;
 
         FFDiskIOResult* device = (FFDiskIOResult*) ffListAdd(result);
+        *device = (FFDiskIOResult) {};
         ffStrbufInitF(&device->devPath, "/dev/%s", provider->lg_name);
         device->bytesRead = snapIter->bytes[DEVSTAT_READ];
         device->readCount = snapIter->operations[DEVSTAT_READ];
@@ -91,6 +92,7 @@ const char* ffDiskIOGetIoCounters(FFlist* result, FFDiskIOOptions* options)
             continue;
 
         FFDiskIOResult* device = (FFDiskIOResult*) ffListAdd(result);
+        *device = (FFDiskIOResult) {};
         ffStrbufInitS(&device->name, deviceName);
         ffStrbufInitF(&device->devPath, "/dev/%s", deviceName);
         device->bytesRead = current->bytes_read;
@@ -5,7 +5,6 @@
 
 #include <ctype.h>
 #include <limits.h>
-#include <inttypes.h>
 #include <fcntl.h>
 
 static void parseDiskIOCounters(int dfd, const char* devName, FFlist* result, FFDiskIOOptions* options)
@@ -52,24 +51,57 @@ static void parseDiskIOCounters(int dfd, const char* devName, FFlist* result, FF
             return;
     }
 
-    // I/Os merges sectors ticks ...
-    uint64_t nRead, sectorRead, nWritten, sectorWritten;
+    // https://www.kernel.org/doc/Documentation/block/stat.txt
+    enum {
+        STAT_READ_IOS, STAT_READ_MERGES, STAT_READ_SECTORS, STAT_READ_TICKS,
+        STAT_WRITE_IOS, STAT_WRITE_MERGES, STAT_WRITE_SECTORS, STAT_WRITE_TICKS,
+        STAT_IN_FLIGHT, STAT_IO_TICKS, STAT_TIME_IN_QUEUE,
+        STAT_DISCARD_IOS, STAT_DISCARD_MERGES, STAT_DISCARD_SECTORS, STAT_DISCARD_TICKS, // Linux 4.18+
+        STAT_FLUSH_IOS, STAT_FLUSH_TICKS, // Linux 5.5+
+        STAT_COUNT,
+    };
+    uint64_t stats[STAT_COUNT] = {};
     {
         char sysBlockStat[PROC_FILE_BUFFSIZ];
         ssize_t fileSize = ffReadFileDataRelative(dfd, "stat", ARRAY_SIZE(sysBlockStat) - 1, sysBlockStat);
         if (fileSize <= 0) return;
         sysBlockStat[fileSize] = '\0';
-        if (sscanf(sysBlockStat, "%" PRIu64 "%*u%" PRIu64 "%*u%" PRIu64 "%*u%" PRIu64 "%*u", &nRead, &sectorRead, &nWritten, &sectorWritten) <= 0)
+
+        // Space separated decimal numbers; older kernels provide fewer fields
+        uint32_t nFields = 0;
+        for (const char* p = sysBlockStat; nFields < STAT_COUNT; ++nFields)
+        {
+            while (*p == ' ') ++p;
+            if (!ffCharIsDigit(*p)) break;
+            uint64_t value = 0;
+            for (; ffCharIsDigit(*p); ++p)
+                value = value * 10 + (uint64_t) (*p - '0');
+            stats[nFields] = value;
+        }
+        if (nFields <= STAT_WRITE_TICKS)
             return;
     }
 
     FFDiskIOResult* device = (FFDiskIOResult*) ffListAdd(result);
+    *device = (FFDiskIOResult) {
+        .bytesRead = stats[STAT_READ_SECTORS] * 512,
+        .readCount = stats[STAT_READ_IOS],
+        .bytesWritten = stats[STAT_WRITE_SECTORS] * 512,
+        .writeCount = stats[STAT_WRITE_IOS],
+        .bytesDiscarded = stats[STAT_DISCARD_SECTORS] * 512,
+        .discardCount = stats[STAT_DISCARD_IOS],
+        .flushCount = stats[STAT_FLUSH_IOS],
+        .readTime = stats[STAT_READ_TICKS],
+        .writeTime = stats[STAT_WRITE_TICKS],
+        .discardTime = stats[STAT_DISCARD_TICKS],
+        .flushTime = stats[STAT_FLUSH_TICKS],
+        .ioTime = stats[STAT_IO_TICKS],
+        .queueTime = stats[STAT_TIME_IN_QUEUE],
+        .inFlight = (uint32_t) stats[STAT_IN_FLIGHT],
+        .hasExtendedStats = true,
+    };
     ffStrbufInitMove(&device->name, &name);
     ffStrbufInitF(&device->devPath, "/dev/%s", devName);
-    device->bytesRead = sectorRead * 512;
-    device->bytesWritten = sectorWritten * 512;
-    device->readCount = nRead;
-    device->writeCount = nWritten;
 }
 
 const char* ffDiskIOGetIoCounters(FFlist* result, FFDiskIOOptions* options)
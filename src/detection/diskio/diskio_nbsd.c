@@ -26,6 +26,7 @@ const char* ffDiskIOGetIoCounters(FFlist* result, FFDiskIOOptions* options)
             continue;
 
         FFDiskIOResult* device = (FFDiskIOResult*) ffListAdd(result);
+        *device = (FFDiskIOResult) {};
         ffStrbufInitF(&device->devPath, "/dev/%s", st->name);
         ffStrbufInitS(&device->name, st->name);
         device->bytesRead = st->rbytes;
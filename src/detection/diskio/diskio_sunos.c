@@ -27,6 +27,7 @@ const char* ffDiskIOGetIoCounters(FFlist* result, FFDiskIOOptions* options)
             continue;
 
         FFDiskIOResult* device = (FFDiskIOResult*) ffListAdd(result);
+        *device = (FFDiskIOResult) {};
         ffStrbufInit(&device->devPath);
         ffStrbufInitS(&device->name, ks->ks_name);
         device->bytesRead = kio.nread;
@@ -11,3 +11,29 @@ const char* ffdsConnectDrm(FFDisplayServerResult* result);
 void ffdsDetectWMDE(FFDisplayServerResult* result);
 
 FFDisplayType ffdsGetDisplayType(const char* drmConnectorName);
+
+#ifdef __linux__
+typedef struct FFDrmConnector
+{
+    FFstrbuf name; // Without the `cardN-` prefix, e.g. `DP-1`
+    uint32_t connectorId;
+    uint32_t modeWidth; // First line of `modes`
+    uint32_t modeHeight;
+    bool hasEdid;
+    // Decoded from EDID
+    FFstrbuf edidName;
+    uint32_t preferredWidth;
+    uint32_t preferredHeight;
+    double preferredRefreshRate;
+    uint32_t physicalWidth; // in mm
+    uint32_t physicalHeight;
+    uint32_t serial;
+    uint16_t myear;
+    uint16_t mweek;
+    bool hdrCompatible;
+} FFDrmConnector;
+
+// Connected connectors in /sys/class/drm, scanned and decoded once per run.
+// The first call is not thread safe
+const FFlist* ffdsGetDrmConnectors(void);
+#endif
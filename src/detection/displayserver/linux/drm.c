@@ -5,103 +5,127 @@
 
 #ifdef __linux__
 #include <dirent.h>
+#include <fcntl.h>
 
-static const char* drmParseSysfs(FFDisplayServerResult* result)
+static void parseDrmConnector(int dfd, FFDrmConnector* connector)
 {
-    const char* drmDirPath = "/sys/class/drm/";
+    uint8_t edidData[512];
+    ssize_t edidLength = ffReadFileDataRelative(dfd, "edid", ARRAY_SIZE(edidData), edidData);
+    if (edidLength > 0 && edidLength % 128 == 0)
+    {
+        connector->hasEdid = true;
+        ffEdidGetName(edidData, &connector->edidName);
+        ffEdidGetPreferredResolutionAndRefreshRate(edidData, &connector->preferredWidth, &connector->preferredHeight, &connector->preferredRefreshRate);
+        ffEdidGetPhysicalSize(edidData, &connector->physicalWidth, &connector->physicalHeight);
+        ffEdidGetSerialAndManufactureDate(edidData, &connector->serial, &connector->myear, &connector->mweek);
+        connector->hdrCompatible = ffEdidGetHdrCompatible(edidData, (uint32_t) edidLength);
+    }
+    else
+    {
+        char modes[32];
+        ssize_t length = ffReadFileDataRelative(dfd, "modes", ARRAY_SIZE(modes) - 1, modes);
+        if (length >= 3)
+        {
+            modes[length] = '\0';
+            sscanf(modes, "%ux%u", &connector->modeWidth, &connector->modeHeight);
+        }
+    }
 
-    FF_AUTO_CLOSE_DIR DIR* dirp = opendir(drmDirPath);
-    if(dirp == NULL)
-        return "opendir(drmDirPath) failed";
+    char connectorId[16];
+    ssize_t length = ffReadFileDataRelative(dfd, "connector_id", ARRAY_SIZE(connectorId) - 1, connectorId);
+    if (length > 0)
+    {
+        connectorId[length] = '\0';
+        connector->connectorId = (uint32_t) strtoul(connectorId, NULL, 10);
+    }
+}
 
-    FF_STRBUF_AUTO_DESTROY drmDir = ffStrbufCreateA(64);
-    ffStrbufAppendS(&drmDir, drmDirPath);
+const FFlist* ffdsGetDrmConnectors(void)
+{
+    static FFlist connectors;
+    static const FFlist* result;
+    static bool init = false;
+    if (init)
+        return result;
+    init = true;
+
+    ffListInit(&connectors, sizeof(FFDrmConnector));
 
-    uint32_t drmDirLength = drmDir.length;
+    FF_AUTO_CLOSE_DIR DIR* dirp = opendir("/sys/class/drm/");
+    if(dirp == NULL)
+        return NULL;
+    result = &connectors;
 
     struct dirent* entry;
     while((entry = readdir(dirp)) != NULL)
     {
-        if(entry->d_name[0] == '.')
+        // Connectors are named `cardN-<connector>`. Skip `cardN`, `renderDN`, `version`, etc
+        if (!ffStrStartsWith(entry->d_name, "card"))
             continue;
-
-        ffStrbufAppendS(&drmDir, entry->d_name);
-        uint32_t drmDirWithDnameLength = drmDir.length;
-
-        char buf;
-        ffStrbufAppendS(&drmDir, "/enabled");
-        if (ffReadFileData(drmDir.chars, sizeof(buf), &buf) <= 0 || buf != 'e') {
-          /* read failed or enabled != "enabled" */
-          ffStrbufSubstrBefore(&drmDir, drmDirWithDnameLength);
-          ffStrbufAppendS(&drmDir, "/status");
-          buf = 'd';
-          ffReadFileData(drmDir.chars, sizeof(buf), &buf);
-          if (buf != 'c') {
-            /* read failed or status != "connected" */
-            ffStrbufSubstrBefore(&drmDir, drmDirLength);
+        const char* plainName = strchr(entry->d_name + strlen("card"), '-');
+        if (!plainName)
             continue;
-          }
-        }
 
-        unsigned width = 0, height = 0, physicalWidth = 0, physicalHeight = 0;
-        double refreshRate = 0;
-        FF_STRBUF_AUTO_DESTROY name = ffStrbufCreate();
-
-        ffStrbufSubstrBefore(&drmDir, drmDirWithDnameLength);
-        ffStrbufAppendS(&drmDir, "/edid");
+        FF_AUTO_CLOSE_FD int dfd = openat(dirfd(dirp), entry->d_name, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (dfd < 0)
+            continue;
 
-        const char* plainName = entry->d_name;
-        if (ffStrStartsWith(plainName, "card"))
+        // Most connectors of multi-output GPUs and MST hubs are disconnected; only read `edid` and `modes` for connected ones
+        char buf;
+        if (ffReadFileDataRelative(dfd, "enabled", sizeof(buf), &buf) <= 0 || buf != 'e')
         {
-            const char* tmp = strchr(plainName + strlen("card"), '-');
-            if (tmp) plainName = tmp + 1;
+            /* read failed or enabled != "enabled" */
+            buf = 'd';
+            ffReadFileDataRelative(dfd, "status", sizeof(buf), &buf);
+            if (buf != 'c')
+                continue; /* read failed or status != "connected" */
         }
 
-        uint8_t edidData[512];
-        ssize_t edidLength = ffReadFileData(drmDir.chars, ARRAY_SIZE(edidData), edidData);
-        if(edidLength <= 0 || edidLength % 128 != 0)
-        {
-            edidLength = 0;
-            ffStrbufSubstrBefore(&drmDir, drmDirWithDnameLength);
-            ffStrbufAppendS(&drmDir, "/modes");
+        FFDrmConnector* connector = ffListAdd(&connectors);
+        *connector = (FFDrmConnector) {
+            .name = ffStrbufCreateS(plainName + 1),
+            .edidName = ffStrbufCreate(),
+        };
+        parseDrmConnector(dfd, connector);
+    }
 
-            char modes[32];
-            if (ffReadFileData(drmDir.chars, ARRAY_SIZE(modes), modes) >= 3)
-            {
-                sscanf(modes, "%ux%u", &width, &height);
-                ffStrbufAppendS(&name, plainName);
-            }
-        }
-        else
-        {
-            ffEdidGetName(edidData, &name);
-            ffEdidGetPreferredResolutionAndRefreshRate(edidData, &width, &height, &refreshRate);
-            ffEdidGetPhysicalSize(edidData, &physicalWidth, &physicalHeight);
-        }
+    return result;
+}
 
+static const char* drmParseSysfs(FFDisplayServerResult* result)
+{
+    const FFlist* connectors = ffdsGetDrmConnectors();
+    if (connectors == NULL)
+        return "opendir(\"/sys/class/drm/\") failed";
+
+    FF_LIST_FOR_EACH(FFDrmConnector, connector, *connectors)
+    {
+        // ffdsAppendDisplay takes the ownership of name
+        FF_STRBUF_AUTO_DESTROY name = ffStrbufCreateCopy(connector->hasEdid ? &connector->edidName : &connector->name);
         FFDisplayResult* item = ffdsAppendDisplay(
             result,
-            width, height,
-            refreshRate,
+            connector->hasEdid ? connector->preferredWidth : connector->modeWidth,
+            connector->hasEdid ? connector->preferredHeight : connector->modeHeight,
+            connector->preferredRefreshRate,
             0, 0,
             0, 0,
             0,
             0,
             &name,
-            ffdsGetDisplayType(plainName),
+            ffdsGetDisplayType(connector->name.chars),
             false,
             0,
-            physicalWidth,
-            physicalHeight,
+            connector->physicalWidth,
+            connector->physicalHeight,
             "sysfs-drm"
         );
-        if (item && edidLength)
+        if (item && connector->hasEdid)
         {
-            item->hdrStatus = ffEdidGetHdrCompatible(edidData, (uint32_t) edidLength) ? FF_DISPLAY_HDR_STATUS_SUPPORTED : FF_DISPLAY_HDR_STATUS_UNSUPPORTED;
-            ffEdidGetSerialAndManufactureDate(edidData, &item->serial, &item->manufactureYear, &item->manufactureWeek);
+            item->hdrStatus = connector->hdrCompatible ? FF_DISPLAY_HDR_STATUS_SUPPORTED : FF_DISPLAY_HDR_STATUS_UNSUPPORTED;
+            item->serial = connector->serial;
+            item->manufactureYear = connector->myear;
+            item->manufactureWeek = connector->mweek;
         }
-
-        ffStrbufSubstrBefore(&drmDir, drmDirLength);
     }
 
     return NULL;
@@ -171,47 +195,6 @@ static inline const char* drmType2Name(uint32_t connector_type)
     }
 }
 
-FF_MAYBE_UNUSED static const char* drmGetEdidByConnId(uint32_t connId, uint8_t* edidData, ssize_t* edidLength)
-{
-    const char* drmDirPath = "/sys/class/drm/";
-
-    FF_AUTO_CLOSE_DIR DIR* dirp = opendir(drmDirPath);
-    if(dirp == NULL)
-        return "opendir(drmDirPath) failed";
-
-    FF_STRBUF_AUTO_DESTROY drmDir = ffStrbufCreateA(64);
-    ffStrbufAppendS(&drmDir, drmDirPath);
-
-    uint32_t drmDirLength = drmDir.length;
-
-    struct dirent* entry;
-    while((entry = readdir(dirp)) != NULL)
-    {
-        if(entry->d_name[0] == '.')
-            continue;
-
-        ffStrbufAppendS(&drmDir, entry->d_name);
-        uint32_t drmDirWithDnameLength = drmDir.length;
-
-        char connectorId[16] = {};
-
-        ffStrbufAppendS(&drmDir, "/connector_id");
-        ffReadFileData(drmDir.chars, ARRAY_SIZE(connectorId), connectorId);
-        if (strtoul(connectorId, NULL, 10) != connId)
-        {
-            ffStrbufSubstrBefore(&drmDir, drmDirLength);
-            continue;
-        }
-
-        ffStrbufSubstrBefore(&drmDir, drmDirWithDnameLength);
-        ffStrbufAppendS(&drmDir, "/edid");
-        *edidLength = ffReadFileData(drmDir.chars, (uint32_t) *edidLength, edidData);
-        return NULL;
-    }
-
-    return "Failed to match connector ID";
-}
-
 static const char* drmConnectLibdrm(FFDisplayServerResult* result)
 {
     FF_LIBRARY_LOAD(libdrm, "dlopen libdrm" FF_LIBRARY_EXTENSION " failed", "libdrm" FF_LIBRARY_EXTENSION, 2)
@@ -373,16 +356,22 @@ static const char* drmConnectLibdrm(FFDisplayServerResult* result)
                 }
 
                 #if __linux__
-                if (name.length == 0)
+                const FFlist* connectors;
+                if (name.length == 0 && (connectors = ffdsGetDrmConnectors()) != NULL)
                 {
-                    uint8_t edidData[512];
-                    ssize_t edidLength = 0;
-                    drmGetEdidByConnId(conn->connector_id, edidData, &edidLength);
-                    if (edidLength > 0 && edidLength % 128 == 0)
+                    FF_LIST_FOR_EACH(FFDrmConnector, connector, *connectors)
                     {
-                        ffEdidGetName(edidData, &name);
-                        hdrStatus = ffEdidGetHdrCompatible(edidData, (uint32_t) edidLength) ? FF_DISPLAY_HDR_STATUS_SUPPORTED : FF_DISPLAY_HDR_STATUS_UNSUPPORTED;
-                        ffEdidGetSerialAndManufactureDate(edidData, &serial, &myear, &mweak);
+                        if (connector->connectorId != conn->connector_id)
+                            continue;
+                        if (connector->hasEdid)
+                        {
+                            ffStrbufSet(&name, &connector->edidName);
+                            hdrStatus = connector->hdrCompatible ? FF_DISPLAY_HDR_STATUS_SUPPORTED : FF_DISPLAY_HDR_STATUS_UNSUPPORTED;
+                            serial = connector->serial;
+                            myear = connector->myear;
+                            mweak = connector->mweek;
+                        }
+                        break;
                     }
                 }
                 #endif
@@ -84,88 +84,83 @@ const char* ffWaylandHandleGlobalOutput(WaylandData* wldata, struct wl_registry*
     if(output == NULL)
         return "Failed to create wl_output";
 
-    WaylandDisplay display = {
-        .parent = wldata,
-        .scale = 1,
-        .transform = WL_OUTPUT_TRANSFORM_NORMAL,
-        .type = FF_DISPLAY_TYPE_UNKNOWN,
-        .name = ffStrbufCreate(),
-        .description = ffStrbufCreate(),
-        .edidName = ffStrbufCreate(),
-    };
-
-    if (wldata->ffwl_proxy_add_listener(output, (void(**)(void)) &outputListener, &display) < 0)
+    WaylandDisplay* display = ffWaylandCreateDisplay(wldata, FF_WAYLAND_PROTOCOL_TYPE_GLOBAL, output, version, 0);
+
+    if (wldata->ffwl_proxy_add_listener(output, (void(**)(void)) &outputListener, display) < 0)
     {
         wldata->ffwl_proxy_destroy(output);
+        display->proxy = NULL;
         return "Failed to add listener to wl_output";
     }
-    if (wldata->ffwl_display_roundtrip(wldata->display) < 0)
-    {
-        wldata->ffwl_proxy_destroy(output);
-        return "Failed to roundtrip wl_output";
-    }
 
-    if (wldata->zxdgOutputManager)
+    return NULL;
+}
+
+void ffWaylandRequestZxdgOutputs(WaylandData* wldata)
+{
+    if (!wldata->zxdgOutputManager)
+        return;
+
+    FF_LIST_FOR_EACH(WaylandDisplay*, pdisplay, wldata->displays)
     {
-        struct wl_proxy* zxdgOutput = wldata->ffwl_proxy_marshal_constructor_versioned(wldata->zxdgOutputManager, ZXDG_OUTPUT_MANAGER_V1_GET_XDG_OUTPUT, &zxdg_output_v1_interface, version, NULL, output);
-
-        if (zxdgOutput)
-        {
-            wldata->ffwl_proxy_add_listener(zxdgOutput, (void(**)(void)) &zxdgOutputListener, &display);
-            wldata->ffwl_display_roundtrip(wldata->display);
-            wldata->ffwl_proxy_destroy(zxdgOutput);
-        }
+        WaylandDisplay* display = *pdisplay;
+        if (display->protocolType != FF_WAYLAND_PROTOCOL_TYPE_GLOBAL || !display->proxy)
+            continue;
+
+        display->xdgOutput = wldata->ffwl_proxy_marshal_constructor_versioned(wldata->zxdgOutputManager, ZXDG_OUTPUT_MANAGER_V1_GET_XDG_OUTPUT, &zxdg_output_v1_interface, display->version, NULL, display->proxy);
+        if (display->xdgOutput)
+            wldata->ffwl_proxy_add_listener(display->xdgOutput, (void(**)(void)) &zxdgOutputListener, display);
     }
+}
 
-    wldata->ffwl_proxy_destroy(output);
+void ffWaylandFinishGlobalOutput(WaylandData* wldata, WaylandDisplay* display)
+{
+    if (display->xdgOutput)
+        wldata->ffwl_proxy_destroy(display->xdgOutput);
+    if (display->proxy)
+        wldata->ffwl_proxy_destroy(display->proxy);
 
-    if(display.width <= 0 || display.height <= 0)
-        return "Failed to get display information from wl_output";
+    if(display->proxy == NULL || display->width <= 0 || display->height <= 0)
+        return;
 
-    uint32_t rotation = ffWaylandHandleRotation(&display);
+    uint32_t rotation = ffWaylandHandleRotation(display);
 
     FFDisplayResult* item = ffdsAppendDisplay(wldata->result,
-        (uint32_t) display.width,
-        (uint32_t) display.height,
-        display.refreshRate / 1000.0,
-        (uint32_t) (display.width / display.scale),
-        (uint32_t) (display.height / display.scale),
-        (uint32_t) display.preferredWidth,
-        (uint32_t) display.preferredHeight,
-        display.preferredRefreshRate / 1000.0,
+        (uint32_t) display->width,
+        (uint32_t) display->height,
+        display->refreshRate / 1000.0,
+        (uint32_t) (display->width / display->scale),
+        (uint32_t) (display->height / display->scale),
+        (uint32_t) display->preferredWidth,
+        (uint32_t) display->preferredHeight,
+        display->preferredRefreshRate / 1000.0,
         rotation,
-        display.edidName.length
-            ? &display.edidName
+        display->edidName.length
+            ? &display->edidName
             // Try ignoring `eDP-1-unknown`, where `unknown` is localized
-            : display.description.length && !ffStrbufContain(&display.description, &display.name)
-                ? &display.description
-                : &display.name,
-        display.type,
+            : display->description.length && !ffStrbufContain(&display->description, &display->name)
+                ? &display->description
+                : &display->name,
+        display->type,
         false,
-        display.id,
-        (uint32_t) display.physicalWidth,
-        (uint32_t) display.physicalHeight,
+        display->id,
+        (uint32_t) display->physicalWidth,
+        (uint32_t) display->physicalHeight,
         "wayland-global"
     );
     if (item)
     {
-        if (display.hdrSupported)
+        if (display->hdrSupported)
             item->hdrStatus = FF_DISPLAY_HDR_STATUS_SUPPORTED;
-        else if (display.hdrInfoAvailable)
+        else if (display->hdrInfoAvailable)
             item->hdrStatus = FF_DISPLAY_HDR_STATUS_UNSUPPORTED;
         else
             item->hdrStatus = FF_DISPLAY_HDR_STATUS_UNKNOWN;
 
-        item->manufactureYear = display.myear;
-        item->manufactureWeek = display.mweek;
-        item->serial = display.serial;
+        item->manufactureYear = display->myear;
+        item->manufactureWeek = display->mweek;
+        item->serial = display->serial;
     }
-
-    ffStrbufDestroy(&display.description);
-    ffStrbufDestroy(&display.name);
-    ffStrbufDestroy(&display.edidName);
-
-    return NULL;
 }
 
 const char* ffWaylandHandleZxdgOutput(WaylandData* wldata, struct wl_registry* registry, uint32_t name, uint32_t version)
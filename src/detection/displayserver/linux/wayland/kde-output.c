@@ -173,77 +173,64 @@ const char* ffWaylandHandleKdeOutput(WaylandData* wldata, struct wl_registry* re
     if(output == NULL)
         return "Failed to create kde_output_device_v2";
 
-    FF_LIST_AUTO_DESTROY modes = ffListCreate(sizeof(WaylandKdeMode));
-    WaylandDisplay display = {
-        .parent = wldata,
-        .scale = 1,
-        .transform = WL_OUTPUT_TRANSFORM_NORMAL,
-        .type = FF_DISPLAY_TYPE_UNKNOWN,
-        .name = ffStrbufCreate(),
-        .description = ffStrbufCreate(),
-        .edidName = ffStrbufCreate(),
-        .internal = &modes,
-    };
-
-    if (wldata->ffwl_proxy_add_listener(output, (void(**)(void)) &outputListener, &display) < 0)
+    WaylandDisplay* display = ffWaylandCreateDisplay(wldata, FF_WAYLAND_PROTOCOL_TYPE_KDE, output, version, sizeof(WaylandKdeMode));
+
+    if (wldata->ffwl_proxy_add_listener(output, (void(**)(void)) &outputListener, display) < 0)
     {
         wldata->ffwl_proxy_destroy(output);
+        display->proxy = NULL;
         return "Failed to add listener to kde_output_device_v2";
     }
 
-    if (wldata->ffwl_display_roundtrip(wldata->display) < 0)
-    {
-        wldata->ffwl_proxy_destroy(output);
-        return "Failed to roundtrip kde_output_device_v2";
-    }
-    wldata->ffwl_proxy_destroy(output);
+    return NULL;
+}
+
+void ffWaylandFinishKdeOutput(WaylandData* wldata, WaylandDisplay* display)
+{
+    if (!display->proxy)
+        return;
+    wldata->ffwl_proxy_destroy(display->proxy);
 
-    if(display.width <= 0 || display.height <= 0 || !display.internal)
-        return "Failed to get display information from kde_output_device_v2";
+    if(display->width <= 0 || display->height <= 0 || !display->internal)
+        return;
 
-    uint32_t rotation = ffWaylandHandleRotation(&display);
+    uint32_t rotation = ffWaylandHandleRotation(display);
 
     FFDisplayResult* item = ffdsAppendDisplay(wldata->result,
-        (uint32_t) display.width,
-        (uint32_t) display.height,
-        display.refreshRate / 1000.0,
-        (uint32_t) (display.width / display.scale),
-        (uint32_t) (display.height / display.scale),
-        (uint32_t) display.preferredWidth,
-        (uint32_t) display.preferredHeight,
-        display.preferredRefreshRate / 1000.0,
+        (uint32_t) display->width,
+        (uint32_t) display->height,
+        display->refreshRate / 1000.0,
+        (uint32_t) (display->width / display->scale),
+        (uint32_t) (display->height / display->scale),
+        (uint32_t) display->preferredWidth,
+        (uint32_t) display->preferredHeight,
+        display->preferredRefreshRate / 1000.0,
         rotation,
-        display.edidName.length
-            ? &display.edidName
-            : &display.name,
-        display.type,
+        display->edidName.length
+            ? &display->edidName
+            : &display->name,
+        display->type,
         false,
-        display.id,
-        (uint32_t) display.physicalWidth,
-        (uint32_t) display.physicalHeight,
+        display->id,
+        (uint32_t) display->physicalWidth,
+        (uint32_t) display->physicalHeight,
         "wayland-kde"
     );
     if (item)
     {
-        if (display.hdrEnabled)
+        if (display->hdrEnabled)
             item->hdrStatus = FF_DISPLAY_HDR_STATUS_ENABLED;
-        else if (display.hdrSupported)
+        else if (display->hdrSupported)
             item->hdrStatus = FF_DISPLAY_HDR_STATUS_SUPPORTED;
-        else if (display.hdrInfoAvailable)
+        else if (display->hdrInfoAvailable)
             item->hdrStatus = FF_DISPLAY_HDR_STATUS_UNSUPPORTED;
         else
             item->hdrStatus = FF_DISPLAY_HDR_STATUS_UNKNOWN;
 
-        item->manufactureYear = display.myear;
-        item->manufactureWeek = display.mweek;
-        item->serial = display.serial;
+        item->manufactureYear = display->myear;
+        item->manufactureWeek = display->mweek;
+        item->serial = display->serial;
     }
-
-    ffStrbufDestroy(&display.description);
-    ffStrbufDestroy(&display.name);
-    ffStrbufDestroy(&display.edidName);
-
-    return NULL;
 }
 
 
@@ -254,28 +241,23 @@ static void waylandKdeOutputOrderListener(void *data, FF_MAYBE_UNUSED struct kde
         *id = ffWaylandGenerateIdFromName(output_name);
 }
 
+static const struct kde_output_order_v1_listener orderListener = {
+    .output = waylandKdeOutputOrderListener,
+    .done = (void*) stubListener,
+};
+
 const char* ffWaylandHandleKdeOutputOrder(WaylandData* wldata, struct wl_registry* registry, uint32_t name, uint32_t version)
 {
     struct wl_proxy* output = wldata->ffwl_proxy_marshal_constructor_versioned((struct wl_proxy*) registry, WL_REGISTRY_BIND, &kde_output_order_v1_interface, version, name, kde_output_order_v1_interface.name, version, NULL);
     if(output == NULL)
         return "Failed to create kde_output_order_v1";
 
-    struct kde_output_order_v1_listener orderListener = {
-        .output = waylandKdeOutputOrderListener,
-        .done = (void*) stubListener,
-    };
-
     if (wldata->ffwl_proxy_add_listener(output, (void(**)(void)) &orderListener, &wldata->primaryDisplayId) < 0)
     {
         wldata->ffwl_proxy_destroy(output);
         return "Failed to add listener to kde_output_order_v1";
     }
-    if (wldata->ffwl_display_roundtrip(wldata->display) < 0)
-    {
-        wldata->ffwl_proxy_destroy(output);
-        return "Failed to roundtrip kde_output_order_v1";
-    }
-    wldata->ffwl_proxy_destroy(output);
+    wldata->kdeOutputOrder = output;
 
     return NULL;
 }
@@ -11,6 +11,7 @@
 #include <sys/socket.h>
 
 #include "common/properties.h"
+#include "common/thread.h"
 
 #include "wayland.h"
 #include "wlr-output-management-unstable-v1-client-protocol.h"
@@ -105,44 +106,64 @@ static void waylandGlobalAddListener(void* data, struct wl_registry* registry, u
     }
 }
 
-static FF_MAYBE_UNUSED bool matchDrmConnector(const char* connName, WaylandDisplay* wldata)
+#if __linux__
+static void scanDrmConnectors(void)
 {
     // https://wayland.freedesktop.org/docs/html/apa.html#protocol-spec-wl_output-event-name
     // The doc says that "do not assume that the name is a reflection of an underlying DRM connector, X11 connection, etc."
     // However I can't find a better method to get the edid data
-    const char* drmDirPath = "/sys/class/drm/";
+    ffdsGetDrmConnectors();
+}
 
-    FF_AUTO_CLOSE_DIR DIR* dirp = opendir(drmDirPath);
-    if(dirp == NULL)
-        return false;
+#ifdef FF_HAVE_THREADS
+FF_THREAD_ENTRY_DECL_WRAPPER_NOPARAM(scanDrmConnectors)
+#endif
+
+static void matchDrmConnector(WaylandDisplay* display)
+{
+    const FFlist* connectors = ffdsGetDrmConnectors();
+    if (!connectors) return;
 
-    struct dirent* entry;
-    while((entry = readdir(dirp)) != NULL)
+    FF_LIST_FOR_EACH(FFDrmConnector, connector, *connectors)
     {
-        const char* plainName = entry->d_name;
-        if (ffStrStartsWith(plainName, "card"))
+        if (ffStrbufEqual(&connector->name, &display->name))
         {
-            const char* tmp = strchr(plainName + strlen("card"), '-');
-            if (tmp) plainName = tmp + 1;
-        }
-        if (ffStrEquals(plainName, connName))
-        {
-            FF_STRBUF_AUTO_DESTROY path = ffStrbufCreateF("%s%s/edid", drmDirPath, entry->d_name);
-
-            uint8_t edidData[512];
-            ssize_t edidLength = ffReadFileData(path.chars, ARRAY_SIZE(edidData), edidData);
-            if (edidLength > 0 && edidLength % 128 == 0)
+            if (connector->hasEdid)
             {
-                ffEdidGetName(edidData, &wldata->edidName);
-                ffEdidGetHdrCompatible(edidData, (uint32_t) edidLength);
-                ffEdidGetSerialAndManufactureDate(edidData, &wldata->serial, &wldata->myear, &wldata->mweek);
-                wldata->hdrInfoAvailable = true;
-                return true;
+                ffStrbufSet(&display->edidName, &connector->edidName);
+                display->hdrSupported = connector->hdrCompatible;
+                display->serial = connector->serial;
+                display->myear = connector->myear;
+                display->mweek = connector->mweek;
+                display->hdrInfoAvailable = true;
             }
-            break;
+            return;
         }
     }
-    return false;
+}
+#endif
+
+WaylandDisplay* ffWaylandCreateDisplay(WaylandData* wldata, WaylandProtocolType protocolType, struct wl_proxy* proxy, uint32_t version, uint32_t modeSize)
+{
+    WaylandDisplay* display = malloc(sizeof(*display));
+    *display = (WaylandDisplay) {
+        .parent = wldata,
+        .scale = 1,
+        .transform = WL_OUTPUT_TRANSFORM_NORMAL,
+        .type = FF_DISPLAY_TYPE_UNKNOWN,
+        .name = ffStrbufCreate(),
+        .description = ffStrbufCreate(),
+        .edidName = ffStrbufCreate(),
+        .protocolType = protocolType,
+        .version = version,
+        .proxy = proxy,
+    };
+    if (modeSize > 0)
+        ffListInit(&display->modes, modeSize);
+    display->internal = &display->modes;
+
+    *(WaylandDisplay**) ffListAdd(&wldata->displays) = display;
+    return display;
 }
 
 void ffWaylandOutputNameListener(void* data, FF_MAYBE_UNUSED void* output, const char *name)
@@ -151,10 +172,6 @@ void ffWaylandOutputNameListener(void* data, FF_MAYBE_UNUSED void* output, const
     if (display->id) return;
 
     display->type = ffdsGetDisplayType(name);
-    #if __linux__
-    if (!display->edidName.length)
-        matchDrmConnector(name, display);
-    #endif
     display->id = ffWaylandGenerateIdFromName(name);
     ffStrbufAppendS(&display->name, name);
 }
@@ -251,11 +268,71 @@ const char* ffdsConnectWayland(FFDisplayServerResult* result)
         .global_remove = (void*) stubListener
     };
 
+    #if __linux__
+    // Reading EDIDs from sysfs doesn't need the compositor. Do it while waiting for its replies
+    #ifdef FF_HAVE_THREADS
+    FFThreadType drmThread = ffThreadCreate(scanDrmConnectorsThreadMain, NULL);
+    if (!drmThread)
+    #endif
+        scanDrmConnectors();
+    #endif
+
+    // All output objects are bound in the global listener, without waiting for their replies
+    ffListInit(&data.displays, sizeof(WaylandDisplay*));
     data.ffwl_proxy_add_listener(registry, (void(**)(void)) &registry_listener, &data);
     data.ffwl_display_roundtrip(data.display);
 
+    // wl_output and zxdg_output_manager_v1 may be announced in any order
+    ffWaylandRequestZxdgOutputs(&data);
+
+    // The replies of all bound objects arrive in one roundtrip
+    if (data.displays.length > 0 || data.zwlrOutputManager || data.kdeOutputOrder)
+        data.ffwl_display_roundtrip(data.display);
+
+    #if __linux__
+    #ifdef FF_HAVE_THREADS
+    if (drmThread)
+        ffThreadJoin(drmThread, 0);
+    #endif
+    #endif
+
+    FF_LIST_FOR_EACH(WaylandDisplay*, pdisplay, data.displays)
+    {
+        WaylandDisplay* display = *pdisplay;
+
+        #if __linux__
+        // kde_output_device_v2 sends EDID itself
+        if (display->protocolType != FF_WAYLAND_PROTOCOL_TYPE_KDE && !display->edidName.length)
+            matchDrmConnector(display);
+        #endif
+
+        switch (display->protocolType)
+        {
+            case FF_WAYLAND_PROTOCOL_TYPE_KDE:
+                ffWaylandFinishKdeOutput(&data, display);
+                break;
+            case FF_WAYLAND_PROTOCOL_TYPE_ZWLR:
+                ffWaylandFinishZwlrOutput(&data, display);
+                break;
+            default:
+                ffWaylandFinishGlobalOutput(&data, display);
+                break;
+        }
+
+        ffStrbufDestroy(&display->description);
+        ffStrbufDestroy(&display->name);
+        ffStrbufDestroy(&display->edidName);
+        ffListDestroy(&display->modes);
+        free(display);
+    }
+    ffListDestroy(&data.displays);
+
     if (data.zxdgOutputManager)
         data.ffwl_proxy_destroy(data.zxdgOutputManager);
+    if (data.zwlrOutputManager)
+        data.ffwl_proxy_destroy(data.zwlrOutputManager);
+    if (data.kdeOutputOrder)
+        data.ffwl_proxy_destroy(data.kdeOutputOrder);
 
     data.ffwl_proxy_destroy(registry);
     ffwl_display_disconnect(data.display);
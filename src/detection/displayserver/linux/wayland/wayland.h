@@ -29,6 +29,9 @@ typedef struct WaylandData
     WaylandProtocolType protocolType;
     uint64_t primaryDisplayId;
     struct wl_proxy* zxdgOutputManager;
+    struct wl_proxy* zwlrOutputManager;
+    struct wl_proxy* kdeOutputOrder;
+    FFlist displays; // WaylandDisplay*, bound during the registry roundtrip and filled by the next one
 } WaylandData;
 
 typedef struct WaylandDisplay
@@ -55,7 +58,12 @@ typedef struct WaylandDisplay
     uint16_t myear;
     uint16_t mweek;
     uint32_t serial;
-    void* internal;
+    WaylandProtocolType protocolType;
+    uint32_t version;
+    struct wl_proxy* proxy; // wl_output, zwlr_output_head_v1 or kde_output_device_v2
+    struct wl_proxy* xdgOutput;
+    FFlist modes;
+    void* internal; // &modes, or NULL if the output is disabled
 } WaylandDisplay;
 
 inline static void stubListener(void* data, ...)
@@ -74,6 +82,8 @@ inline static uint64_t ffWaylandGenerateIdFromName(const char* name)
     return id;
 }
 
+// Listeners keep pointers to the display, so it's allocated on heap and owned by `wldata->displays`
+WaylandDisplay* ffWaylandCreateDisplay(WaylandData* wldata, WaylandProtocolType protocolType, struct wl_proxy* proxy, uint32_t version, uint32_t modeSize);
 void ffWaylandOutputNameListener(void* data, FF_MAYBE_UNUSED void* output, const char *name);
 void ffWaylandOutputDescriptionListener(void* data, FF_MAYBE_UNUSED void* output, const char* description);
 // Modifies content of display. Don't call this function when calling ffdsAppendDisplay
@@ -85,4 +95,12 @@ const char* ffWaylandHandleKdeOutput(WaylandData* wldata, struct wl_registry* re
 const char* ffWaylandHandleKdeOutputOrder(WaylandData* wldata, struct wl_registry* registry, uint32_t name, uint32_t version);
 const char* ffWaylandHandleZxdgOutput(WaylandData* wldata, struct wl_registry* registry, uint32_t name, uint32_t version);
 
+// Must be called after the registry roundtrip, when both wl_outputs and zxdg_output_manager_v1 are bound
+void ffWaylandRequestZxdgOutputs(WaylandData* wldata);
+
+// Called after the final roundtrip. Append the display to the result and release its proxies
+void ffWaylandFinishGlobalOutput(WaylandData* wldata, WaylandDisplay* display);
+void ffWaylandFinishZwlrOutput(WaylandData* wldata, WaylandDisplay* display);
+void ffWaylandFinishKdeOutput(WaylandData* wldata, WaylandDisplay* display);
+
 #endif
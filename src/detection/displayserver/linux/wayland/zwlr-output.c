@@ -122,95 +122,79 @@ static void waylandHandleZwlrHead(void *data, FF_MAYBE_UNUSED struct zwlr_output
 {
     WaylandData* wldata = data;
 
-    FF_LIST_AUTO_DESTROY modes = ffListCreate(sizeof(WaylandZwlrMode));
-    WaylandDisplay display = {
-        .parent = wldata,
-        .scale = 1,
-        .transform = WL_OUTPUT_TRANSFORM_NORMAL,
-        .type = FF_DISPLAY_TYPE_UNKNOWN,
-        .name = ffStrbufCreate(),
-        .description = ffStrbufCreate(),
-        .edidName = ffStrbufCreate(),
-        .internal = &modes,
-    };
-
-    wldata->ffwl_proxy_add_listener((struct wl_proxy*) head, (void(**)(void)) &headListener, &display);
-    wldata->ffwl_display_roundtrip(wldata->display);
-
-    if(display.width <= 0 || display.height <= 0 || !display.internal)
+    WaylandDisplay* display = ffWaylandCreateDisplay(wldata, FF_WAYLAND_PROTOCOL_TYPE_ZWLR, (struct wl_proxy*) head, 0, sizeof(WaylandZwlrMode));
+    wldata->ffwl_proxy_add_listener((struct wl_proxy*) head, (void(**)(void)) &headListener, display);
+}
+
+void ffWaylandFinishZwlrOutput(WaylandData* wldata, WaylandDisplay* display)
+{
+    // These must be released manually
+    FF_LIST_FOR_EACH(WaylandZwlrMode, m, display->modes)
+        wldata->ffwl_proxy_destroy((void*) m->pMode);
+    wldata->ffwl_proxy_destroy(display->proxy);
+
+    if(display->width <= 0 || display->height <= 0 || !display->internal)
         return;
 
-    uint32_t rotation = ffWaylandHandleRotation(&display);
+    uint32_t rotation = ffWaylandHandleRotation(display);
 
     FFDisplayResult* item = ffdsAppendDisplay(wldata->result,
-        (uint32_t) display.width,
-        (uint32_t) display.height,
-        display.refreshRate / 1000.0,
-        (uint32_t) (display.width / display.scale + 0.5),
-        (uint32_t) (display.height / display.scale + 0.5),
-        (uint32_t) display.preferredWidth,
-        (uint32_t) display.preferredHeight,
-        display.preferredRefreshRate / 1000.0,
+        (uint32_t) display->width,
+        (uint32_t) display->height,
+        display->refreshRate / 1000.0,
+        (uint32_t) (display->width / display->scale + 0.5),
+        (uint32_t) (display->height / display->scale + 0.5),
+        (uint32_t) display->preferredWidth,
+        (uint32_t) display->preferredHeight,
+        display->preferredRefreshRate / 1000.0,
         rotation,
-        display.edidName.length
-            ? &display.edidName
-            : display.description.length && !ffStrbufContain(&display.description, &display.name)
-                ? &display.description
-                : &display.name,
-        display.type,
+        display->edidName.length
+            ? &display->edidName
+            : display->description.length && !ffStrbufContain(&display->description, &display->name)
+                ? &display->description
+                : &display->name,
+        display->type,
         false,
-        display.id,
-        (uint32_t) display.physicalWidth,
-        (uint32_t) display.physicalHeight,
+        display->id,
+        (uint32_t) display->physicalWidth,
+        (uint32_t) display->physicalHeight,
         "wayland-zwlr"
     );
     if (item)
     {
-        if (display.hdrSupported)
+        if (display->hdrSupported)
             item->hdrStatus = FF_DISPLAY_HDR_STATUS_SUPPORTED;
-        else if (display.hdrInfoAvailable)
+        else if (display->hdrInfoAvailable)
             item->hdrStatus = FF_DISPLAY_HDR_STATUS_UNSUPPORTED;
         else
             item->hdrStatus = FF_DISPLAY_HDR_STATUS_UNKNOWN;
 
-        item->manufactureYear = display.myear;
-        item->manufactureWeek = display.mweek;
-        item->serial = display.serial;
+        item->manufactureYear = display->myear;
+        item->manufactureWeek = display->mweek;
+        item->serial = display->serial;
     }
-
-    ffStrbufDestroy(&display.description);
-    ffStrbufDestroy(&display.name);
-    ffStrbufDestroy(&display.edidName);
-
-    // These must be released manually
-    FF_LIST_FOR_EACH(WaylandZwlrMode, m, modes)
-        wldata->ffwl_proxy_destroy((void*) m->pMode);
-    wldata->ffwl_proxy_destroy((void*) head);
 }
 
+static const struct zwlr_output_manager_v1_listener managerListener = {
+    .head = waylandHandleZwlrHead,
+    .done = (void*) stubListener,
+    .finished = (void*) stubListener,
+};
+
 const char* ffWaylandHandleZwlrOutput(WaylandData* wldata, struct wl_registry* registry, uint32_t name, uint32_t version)
 {
     struct wl_proxy* output = wldata->ffwl_proxy_marshal_constructor_versioned((struct wl_proxy*) registry, WL_REGISTRY_BIND, &zwlr_output_manager_v1_interface, version, name, zwlr_output_manager_v1_interface.name, version, NULL);
     if(output == NULL)
         return "Failed to bind zwlr_output_manager_v1";
 
-    const struct zwlr_output_manager_v1_listener outputListener = {
-        .head = waylandHandleZwlrHead,
-        .done = (void*) stubListener,
-        .finished = (void*) stubListener,
-    };
-
-    if (wldata->ffwl_proxy_add_listener(output, (void(**)(void)) &outputListener, wldata) < 0)
+    if (wldata->ffwl_proxy_add_listener(output, (void(**)(void)) &managerListener, wldata) < 0)
     {
         wldata->ffwl_proxy_destroy(output);
         return "Failed to add listener to zwlr_output_manager_v1";
     }
-    if (wldata->ffwl_display_roundtrip(wldata->display) < 0)
-    {
-        wldata->ffwl_proxy_destroy(output);
-        return "Failed to roundtrip display";
-    }
-    wldata->ffwl_proxy_destroy(output);
+
+    // Heads are announced with all their properties in the next roundtrip
+    wldata->zwlrOutputManager = output;
 
     return NULL;
 }
@@ -1,5 +1,6 @@
 #include "displayserver_linux.h"
 #include "common/io/io.h"
+#include "common/processing.h"
 #include "common/properties.h"
 #include "util/stringUtils.h"
 #include "util/mallocHelper.h"
@@ -352,53 +353,31 @@ static const char* getFromProcesses(FFDisplayServerResult* result)
         }
     }
 #elif __linux__
-    FF_AUTO_CLOSE_DIR DIR* procdir = opendir("/proc");
-    if(procdir == NULL)
+    const FFlist* processes = ffProcessTableList();
+    if(processes->length == 0)
         return "opendir(\"/proc\") failed";
 
-    FF_STRBUF_AUTO_DESTROY procPath = ffStrbufCreateA(64);
-    ffStrbufAppendS(&procPath, "/proc/");
-
-    uint32_t procPathLength = procPath.length;
-
-    FF_STRBUF_AUTO_DESTROY loginuid = ffStrbufCreate();
-    FF_STRBUF_AUTO_DESTROY processName = ffStrbufCreateA(256); //Some processes have large command lines (looking at you chrome)
-
-    struct dirent* dirent;
-    while((dirent = readdir(procdir)) != NULL)
+    FF_LIST_FOR_EACH(FFProcessEntry*, pentry, *processes)
     {
-        //Match only folders starting with a number (the pid folders)
-        if(dirent->d_type != DT_DIR || !ffCharIsDigit(dirent->d_name[0]))
-            continue;
-
-        ffStrbufAppendS(&procPath, dirent->d_name);
-        uint32_t procFolderPathLength = procPath.length;
+        FFProcessEntry* entry = *pentry;
 
         //Don't check for processes not owend by the current user.
-        ffStrbufAppendS(&procPath, "/loginuid");
-        ffReadFileBuffer(procPath.chars, &loginuid);
-        if(ffStrbufToUInt(&loginuid, (uint64_t) -1) != userId)
-        {
-            ffStrbufSubstrBefore(&procPath, procPathLength);
+        ffProcessTableLoad(entry, FF_PROCESS_ENTRY_LOGINUID);
+        if(entry->loginuid != userId)
             continue;
-        }
-
-        ffStrbufSubstrBefore(&procPath, procFolderPathLength);
 
         //We check the cmdline for the process name, because it is not trimmed.
-        ffStrbufAppendS(&procPath, "/cmdline");
-        ffReadFileBuffer(procPath.chars, &processName);
-        ffStrbufTrimRightSpace(&processName);
-        ffStrbufSubstrBeforeFirstC(&processName, '\0'); //Trim the arguments
-        ffStrbufSubstrAfterLastC(&processName, '/');
-
-        ffStrbufSubstrBefore(&procPath, procPathLength);
+        ffProcessTableLoad(entry, FF_PROCESS_ENTRY_CMDLINE);
+        const char* processName = entry->cmdline.chars; //Trim the arguments
+        const char* slash = strrchr(processName, '/');
+        if(slash)
+            processName = slash + 1;
 
         if(result->dePrettyName.length == 0)
-            applyPrettyNameIfDE(result, processName.chars);
+            applyPrettyNameIfDE(result, processName);
 
         if(result->wmPrettyName.length == 0)
-            applyNameIfWM(result, processName.chars);
+            applyNameIfWM(result, processName);
 
         if(result->dePrettyName.length > 0 && result->wmPrettyName.length > 0)
             break;
@@ -16,6 +16,12 @@
 #include <linux/ethtool.h>
 #include <linux/sockios.h>
 #include <linux/if.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <linux/genetlink.h>
+#if __has_include(<linux/ethtool_netlink.h>)
+#include <linux/ethtool_netlink.h>
+#endif
 #endif
 
 #if defined(__FreeBSD__) || defined(__OpenBSD__) || defined(__APPLE__) || defined(__NetBSD__) || defined(__HAIKU__)
@@ -129,7 +135,288 @@ static void addNewIp(FFlist* list, const char* name, const char* addr, int type,
     }
 }
 
-const char* ffDetectLocalIps(const FFLocalIpOptions* options, FFlist* results)
+#ifdef __linux__
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wsign-conversion" // NLMSG_NEXT / RTA_NEXT
+
+typedef struct FFNetlinkLinkInfo
+{
+    uint32_t index;
+    uint32_t flags;
+    int32_t mtu;
+    bool isDefaultRoute;
+    char name[IF_NAMESIZE + 1];
+} FFNetlinkLinkInfo;
+
+#ifdef ETHTOOL_GENL_NAME
+static bool detectSpeedByEthtoolNetlink(FFlist* results)
+{
+    FF_AUTO_CLOSE_FD int sock = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_GENERIC);
+    if (sock < 0)
+        return false;
+
+    uint16_t familyId = ffNetlinkGetGenlFamily(sock, ETHTOOL_GENL_NAME);
+    if (familyId == 0)
+        return false; // Linux < 5.6 or ethtool netlink disabled
+
+    struct {
+        struct nlmsghdr nlh;
+        struct genlmsghdr genl;
+        struct nlattr header;
+        struct nlattr flags;
+        uint32_t flagsValue;
+    } req = {
+        .nlh = {
+            .nlmsg_len = sizeof(req),
+            .nlmsg_type = familyId,
+            .nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP,
+            .nlmsg_seq = 2,
+        },
+        .genl = {
+            .cmd = ETHTOOL_MSG_LINKMODES_GET,
+            .version = ETHTOOL_GENL_VERSION,
+        },
+        .header = {
+            .nla_len = NLA_HDRLEN * 2 + sizeof(uint32_t),
+            .nla_type = NLA_F_NESTED | ETHTOOL_A_LINKMODES_HEADER,
+        },
+        .flags = {
+            .nla_len = NLA_HDRLEN + sizeof(uint32_t),
+            .nla_type = ETHTOOL_A_HEADER_FLAGS,
+        },
+        // We don't need link mode bitsets; compact ones are much smaller than the verbose (named) form
+        .flagsValue = ETHTOOL_FLAG_COMPACT_BITSETS,
+    };
+
+    FF_STRBUF_AUTO_DESTROY reply = ffStrbufCreate();
+    if (!ffNetlinkRequest(sock, &req, &reply))
+        return false;
+
+    int remaining = (int) reply.length;
+    for (struct nlmsghdr* nlh = (struct nlmsghdr*) reply.chars; NLMSG_OK(nlh, remaining); nlh = NLMSG_NEXT(nlh, remaining))
+    {
+        if (nlh->nlmsg_type != familyId)
+            continue;
+
+        const char* ifName = NULL;
+        uint32_t speed = (uint32_t) -1; // SPEED_UNKNOWN
+
+        int attrLen = (int) NLMSG_PAYLOAD(nlh, GENL_HDRLEN);
+        for (struct rtattr* rta = (struct rtattr*) ((uint8_t*) NLMSG_DATA(nlh) + GENL_HDRLEN); RTA_OK(rta, attrLen); rta = RTA_NEXT(rta, attrLen))
+        {
+            switch (rta->rta_type & NLA_TYPE_MASK)
+            {
+            case ETHTOOL_A_LINKMODES_HEADER: {
+                int nestLen = (int) RTA_PAYLOAD(rta);
+                for (struct rtattr* nest = (struct rtattr*) RTA_DATA(rta); RTA_OK(nest, nestLen); nest = RTA_NEXT(nest, nestLen))
+                {
+                    if (nest->rta_type == ETHTOOL_A_HEADER_DEV_NAME)
+                        ifName = (const char*) RTA_DATA(nest);
+                }
+                break;
+            }
+            case ETHTOOL_A_LINKMODES_SPEED:
+                speed = *(uint32_t*) RTA_DATA(rta);
+                break;
+            }
+        }
+
+        if (!ifName || speed == (uint32_t) -1)
+            continue;
+
+        FF_LIST_FOR_EACH(FFLocalIpResult, iface, *results)
+        {
+            if (ffStrbufEqualS(&iface->name, ifName))
+            {
+                iface->speed = (int32_t) speed;
+                break;
+            }
+        }
+    }
+
+    return true;
+}
+#endif
+
+// Fetches links and addresses with two rtnetlink dumps, instead of getifaddrs + per-interface ioctls
+static bool detectByNetlink(const FFLocalIpOptions* options, FFlist* results, FFLocalIpType* ioctlTypes)
+{
+    FF_AUTO_CLOSE_FD int sock = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+    if (sock < 0)
+        return false;
+
+    struct {
+        struct nlmsghdr nlh;
+        struct ifinfomsg ifi;
+    } linkReq = {
+        .nlh = {
+            .nlmsg_len = NLMSG_LENGTH(sizeof(struct ifinfomsg)),
+            .nlmsg_type = RTM_GETLINK,
+            .nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP,
+            .nlmsg_seq = 1,
+        },
+        .ifi = {
+            .ifi_family = AF_UNSPEC,
+        },
+    };
+    FF_STRBUF_AUTO_DESTROY linkReply = ffStrbufCreate();
+    if (!ffNetlinkRequest(sock, &linkReq, &linkReply))
+        return false;
+
+    struct {
+        struct nlmsghdr nlh;
+        struct ifaddrmsg ifa;
+    } addrReq = {
+        .nlh = {
+            .nlmsg_len = NLMSG_LENGTH(sizeof(struct ifaddrmsg)),
+            .nlmsg_type = RTM_GETADDR,
+            .nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP,
+            .nlmsg_seq = 2,
+        },
+        .ifa = {
+            .ifa_family = (options->showType & FF_LOCALIP_TYPE_IPV4_BIT)
+                ? (options->showType & FF_LOCALIP_TYPE_IPV6_BIT) ? AF_UNSPEC : AF_INET
+                : AF_INET6,
+        },
+    };
+    FF_STRBUF_AUTO_DESTROY addrReply = ffStrbufCreate();
+    if ((options->showType & (FF_LOCALIP_TYPE_IPV4_BIT | FF_LOCALIP_TYPE_IPV6_BIT)) && !ffNetlinkRequest(sock, &addrReq, &addrReply))
+        return false;
+
+    const char* defaultRouteIfName = ffNetifGetDefaultRouteIfName();
+    FF_LIST_AUTO_DESTROY links = ffListCreate(sizeof(FFNetlinkLinkInfo));
+
+    int remaining = (int) linkReply.length;
+    for (struct nlmsghdr* nlh = (struct nlmsghdr*) linkReply.chars; NLMSG_OK(nlh, remaining); nlh = NLMSG_NEXT(nlh, remaining))
+    {
+        if (nlh->nlmsg_type != RTM_NEWLINK)
+            continue;
+
+        struct ifinfomsg* ifi = (struct ifinfomsg*) NLMSG_DATA(nlh);
+        if (!(ifi->ifi_flags & IFF_RUNNING))
+            continue;
+        if ((ifi->ifi_flags & IFF_LOOPBACK) && !(options->showType & FF_LOCALIP_TYPE_LOOP_BIT))
+            continue;
+
+        const char* ifName = NULL;
+        const uint8_t* mac = NULL;
+        int32_t mtu = -1;
+
+        int attrLen = (int) IFLA_PAYLOAD(nlh);
+        for (struct rtattr* rta = IFLA_RTA(ifi); RTA_OK(rta, attrLen); rta = RTA_NEXT(rta, attrLen))
+        {
+            switch (rta->rta_type)
+            {
+            case IFLA_IFNAME:
+                ifName = (const char*) RTA_DATA(rta);
+                break;
+            case IFLA_MTU:
+                mtu = *(int32_t*) RTA_DATA(rta);
+                break;
+            case IFLA_ADDRESS:
+                if (RTA_PAYLOAD(rta) >= 6)
+                    mac = (const uint8_t*) RTA_DATA(rta);
+                break;
+            }
+        }
+        if (!ifName)
+            continue;
+
+        bool isDefaultRoute = ffStrEquals(defaultRouteIfName, ifName);
+        if ((options->showType & FF_LOCALIP_TYPE_DEFAULT_ROUTE_ONLY_BIT) && !isDefaultRoute)
+            continue;
+
+        if (options->namePrefix.length && strncmp(ifName, options->namePrefix.chars, options->namePrefix.length) != 0)
+            continue;
+
+        FFNetlinkLinkInfo* link = (FFNetlinkLinkInfo*) ffListAdd(&links);
+        link->index = (uint32_t) ifi->ifi_index;
+        link->flags = options->showType & FF_LOCALIP_TYPE_FLAGS_BIT ? ifi->ifi_flags : 0;
+        link->mtu = mtu;
+        link->isDefaultRoute = isDefaultRoute;
+        ffStrCopy(link->name, ifName, sizeof(link->name));
+
+        if ((options->showType & FF_LOCALIP_TYPE_MAC_BIT) && mac)
+        {
+            char addressBuffer[32];
+            snprintf(addressBuffer, ARRAY_SIZE(addressBuffer), "%02x:%02x:%02x:%02x:%02x:%02x",
+                        mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+            addNewIp(results, link->name, addressBuffer, -1, isDefaultRoute, link->flags, false);
+        }
+    }
+
+    remaining = (int) addrReply.length;
+    for (struct nlmsghdr* nlh = (struct nlmsghdr*) addrReply.chars; NLMSG_OK(nlh, remaining); nlh = NLMSG_NEXT(nlh, remaining))
+    {
+        if (nlh->nlmsg_type != RTM_NEWADDR)
+            continue;
+
+        struct ifaddrmsg* ifa = (struct ifaddrmsg*) NLMSG_DATA(nlh);
+        if (ifa->ifa_family == AF_INET ? !(options->showType & FF_LOCALIP_TYPE_IPV4_BIT) :
+            ifa->ifa_family == AF_INET6 ? !(options->showType & FF_LOCALIP_TYPE_IPV6_BIT) : true)
+            continue;
+
+        FFNetlinkLinkInfo* link = NULL;
+        FF_LIST_FOR_EACH(FFNetlinkLinkInfo, temp, links)
+        {
+            if (temp->index != ifa->ifa_index) continue;
+            link = temp;
+            break;
+        }
+        if (!link)
+            continue;
+
+        // Same as getifaddrs: IFA_LOCAL is the local address of point-to-point links, where IFA_ADDRESS is the peer
+        const void* address = NULL;
+        int attrLen = (int) IFA_PAYLOAD(nlh);
+        for (struct rtattr* rta = IFA_RTA(ifa); RTA_OK(rta, attrLen); rta = RTA_NEXT(rta, attrLen))
+        {
+            if (rta->rta_type == IFA_LOCAL || (rta->rta_type == IFA_ADDRESS && !address))
+                address = RTA_DATA(rta);
+        }
+        if (!address)
+            continue;
+
+        char addressBuffer[INET6_ADDRSTRLEN + 16];
+        inet_ntop(ifa->ifa_family, address, addressBuffer, INET6_ADDRSTRLEN);
+
+        if ((options->showType & FF_LOCALIP_TYPE_PREFIX_LEN_BIT) && ifa->ifa_prefixlen != 0)
+        {
+            size_t len = strlen(addressBuffer);
+            snprintf(addressBuffer + len, 16, "/%u", (unsigned) ifa->ifa_prefixlen);
+        }
+
+        addNewIp(results, link->name, addressBuffer, ifa->ifa_family, link->isDefaultRoute, link->flags, !(options->showType & FF_LOCALIP_TYPE_ALL_IPS_BIT));
+    }
+
+    if (options->showType & FF_LOCALIP_TYPE_MTU_BIT)
+    {
+        FF_LIST_FOR_EACH(FFLocalIpResult, iface, *results)
+        {
+            FF_LIST_FOR_EACH(FFNetlinkLinkInfo, link, links)
+            {
+                if (!ffStrbufEqualS(&iface->name, link->name)) continue;
+                iface->mtu = link->mtu;
+                break;
+            }
+        }
+    }
+
+    *ioctlTypes &= ~FF_LOCALIP_TYPE_MTU_BIT;
+    #ifdef ETHTOOL_GENL_NAME
+    if ((options->showType & FF_LOCALIP_TYPE_SPEED_BIT) && results->length > 0 && detectSpeedByEthtoolNetlink(results))
+        *ioctlTypes &= ~FF_LOCALIP_TYPE_SPEED_BIT;
+    #endif
+
+    return true;
+}
+
+#pragma GCC diagnostic pop
+
+#endif
+
+static const char* detectByGetifaddrs(const FFLocalIpOptions* options, FFlist* results)
 {
     struct ifaddrs* ifAddrStruct = NULL;
     if(getifaddrs(&ifAddrStruct) < 0)
@@ -234,11 +521,26 @@ const char* ffDetectLocalIps(const FFLocalIpOptions* options, FFlist* results)
 
     if (ifAddrStruct) freeifaddrs(ifAddrStruct);
 
-    if ((options->showType & FF_LOCALIP_TYPE_MTU_BIT) || (options->showType & FF_LOCALIP_TYPE_SPEED_BIT)
+    return NULL;
+}
+
+const char* ffDetectLocalIps(const FFLocalIpOptions* options, FFlist* results)
+{
+    FFLocalIpType ioctlTypes = options->showType & (FF_LOCALIP_TYPE_MTU_BIT | FF_LOCALIP_TYPE_SPEED_BIT
         #ifdef __sun
-        || (options->showType & FF_LOCALIP_TYPE_MAC_BIT)
+        | FF_LOCALIP_TYPE_MAC_BIT
         #endif
-    )
+    );
+
+    #ifdef __linux__
+    if (!detectByNetlink(options, results, &ioctlTypes))
+    #endif
+    {
+        const char* error = detectByGetifaddrs(options, results);
+        if (error) return error;
+    }
+
+    if (ioctlTypes)
     {
         FF_AUTO_CLOSE_FD int sockfd = socket(AF_INET, SOCK_DGRAM, 0);
         if (sockfd > 0)
@@ -248,13 +550,13 @@ const char* ffDetectLocalIps(const FFLocalIpOptions* options, FFlist* results)
                 struct ifreq ifr;
                 ffStrCopy(ifr.ifr_name, iface->name.chars, IFNAMSIZ);
 
-                if (options->showType & FF_LOCALIP_TYPE_MTU_BIT)
+                if (ioctlTypes & FF_LOCALIP_TYPE_MTU_BIT)
                 {
                     if (ioctl(sockfd, SIOCGIFMTU, &ifr) == 0)
                         iface->mtu = (int32_t) ifr.ifr_mtu;
                 }
 
-                if (options->showType & FF_LOCALIP_TYPE_SPEED_BIT)
+                if (ioctlTypes & FF_LOCALIP_TYPE_SPEED_BIT)
                 {
                     #ifdef __linux__
                     struct ethtool_cmd edata = { .cmd = ETHTOOL_GSET };
@@ -636,7 +938,7 @@ const char* ffDetectLocalIps(const FFLocalIpOptions* options, FFlist* results)
                 }
 
                 #ifdef __sun
-                if ((options->showType & FF_LOCALIP_TYPE_MAC_BIT) && ioctl(sockfd, SIOCGIFHWADDR, &ifr) == 0)
+                if ((ioctlTypes & FF_LOCALIP_TYPE_MAC_BIT) && ioctl(sockfd, SIOCGIFHWADDR, &ifr) == 0)
                 {
                     const uint8_t* ptr = (uint8_t*) ifr.ifr_addr.sa_data; // NOT ifr_enaddr
                     ffStrbufSetF(&iface->mac, "%02x:%02x:%02x:%02x:%02x:%02x",
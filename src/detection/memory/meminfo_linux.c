@@ -0,0 +1,91 @@
+#include "meminfo_linux.h"
+#include "common/io/io.h"
+
+#include <stdlib.h>
+
+static void parseMeminfo(char* buf, FFMeminfo* info)
+{
+    for (char* line = buf; *line; )
+    {
+        char* colon = strchr(line, ':');
+        if (!colon) break;
+
+        char* end;
+        uint64_t value = strtoull(colon + 1, &end, 10);
+        size_t keyLength = (size_t) (colon - line);
+
+        #define FF_MEMINFO_KEY(key, field) \
+            if (keyLength == strlen(key) && memcmp(line, key, strlen(key)) == 0) { info->field = value; break; }
+
+        switch (line[0])
+        {
+            case 'M':
+                FF_MEMINFO_KEY("MemTotal", memTotal);
+                FF_MEMINFO_KEY("MemFree", memFree);
+                if (keyLength == strlen("MemAvailable") && memcmp(line, "MemAvailable", strlen("MemAvailable")) == 0)
+                {
+                    info->memAvailable = value;
+                    info->hasMemAvailable = true;
+                }
+                break;
+            case 'B':
+                FF_MEMINFO_KEY("Buffers", buffers);
+                break;
+            case 'C':
+                FF_MEMINFO_KEY("Cached", cached);
+                break;
+            case 'S':
+                FF_MEMINFO_KEY("Shmem", shmem);
+                FF_MEMINFO_KEY("Slab", slab);
+                FF_MEMINFO_KEY("SReclaimable", sReclaimable);
+                FF_MEMINFO_KEY("SwapTotal", swapTotal);
+                FF_MEMINFO_KEY("SwapFree", swapFree);
+                break;
+            case 'Z':
+                FF_MEMINFO_KEY("Zswap", zswap);
+                FF_MEMINFO_KEY("Zswapped", zswapped);
+                break;
+            case 'D':
+                FF_MEMINFO_KEY("Dirty", dirty);
+                break;
+            case 'W':
+                FF_MEMINFO_KEY("Writeback", writeback);
+                break;
+            case 'H':
+                FF_MEMINFO_KEY("HugePages_Total", hugePagesTotal);
+                FF_MEMINFO_KEY("HugePages_Free", hugePagesFree);
+                FF_MEMINFO_KEY("Hugepagesize", hugePageSize);
+                break;
+        }
+
+        #undef FF_MEMINFO_KEY
+
+        char* newline = strchr(end, '\n');
+        if (!newline) break;
+        line = newline + 1;
+    }
+}
+
+const char* ffMeminfoGet(const FFMeminfo** result)
+{
+    static FFMeminfo info;
+    static const char* error;
+    static bool init;
+
+    if (!init)
+    {
+        init = true;
+        char buf[PROC_FILE_BUFFSIZ];
+        ssize_t nRead = ffReadFileData("/proc/meminfo", ARRAY_SIZE(buf) - 1, buf);
+        if (nRead < 0)
+            error = "ffReadFileData(\"/proc/meminfo\", ARRAY_SIZE(buf)-1, buf)";
+        else
+        {
+            buf[nRead] = '\0';
+            parseMeminfo(buf, &info);
+        }
+    }
+
+    *result = &info;
+    return error;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "fastfetch.h"
+
+// Values of /proc/meminfo, in KiB except `hugePages*`, which are page counts
+typedef struct FFMeminfo
+{
+    uint64_t memTotal;
+    uint64_t memFree;
+    uint64_t memAvailable;
+    uint64_t buffers;
+    uint64_t cached;
+    uint64_t shmem;
+    uint64_t slab;
+    uint64_t sReclaimable;
+    uint64_t swapTotal;
+    uint64_t swapFree;
+    uint64_t zswap;
+    uint64_t zswapped;
+    uint64_t dirty;
+    uint64_t writeback;
+    uint64_t hugePagesTotal;
+    uint64_t hugePagesFree;
+    uint64_t hugePageSize;
+    bool hasMemAvailable; // Linux >= 3.14
+} FFMeminfo;
+
+// /proc/meminfo is read and parsed once per run and shared by Memory and Swap
+const char* ffMeminfoGet(const FFMeminfo** result);
@@ -6,6 +6,16 @@ typedef struct FFMemoryResult
 {
     uint64_t bytesUsed;
     uint64_t bytesTotal;
+
+    // Kernel memory counters, currently only detected on Linux
+    uint64_t bytesDirty;
+    uint64_t bytesWriteback;
+    uint64_t bytesSlab;
+    uint64_t bytesZswap; // compressed size
+    uint64_t bytesZswapped; // uncompressed size
+    uint64_t bytesHugePagesTotal;
+    uint64_t bytesHugePagesUsed;
+    bool detailsAvailable; // set by backends that fill the counters above
 } FFMemoryResult;
 
 const char* ffDetectMemory(FFMemoryResult* ram);
@@ -1,10 +1,70 @@
 #include "netio.h"
 
 #include "common/time.h"
+#include "common/snapshot.h"
+#include "util/mallocHelper.h"
 
 static FFlist ioCounters1;
 static uint64_t time1;
 
+static const size_t snapshotCounters[] = {
+    offsetof(FFNetIOResult, txBytes),
+    offsetof(FFNetIOResult, rxBytes),
+    offsetof(FFNetIOResult, txPackets),
+    offsetof(FFNetIOResult, rxPackets),
+    offsetof(FFNetIOResult, rxErrors),
+    offsetof(FFNetIOResult, txErrors),
+    offsetof(FFNetIOResult, rxDrops),
+    offsetof(FFNetIOResult, txDrops),
+};
+
+static void getSnapshotName(const FFNetIOOptions* options, FFstrbuf* name)
+{
+    FF_STRBUF_AUTO_DESTROY filter = ffStrbufCreateCopy(&options->namePrefix);
+    if (options->defaultRouteOnly)
+        ffStrbufAppendS(&filter, "\ndefaultRouteOnly");
+    ffSnapshotGetName("netio", &filter, name);
+}
+
+// Use the counters saved by the previous run as the first sample, if they are recent enough
+static void loadSnapshot(FFNetIOOptions* options)
+{
+    FF_STRBUF_AUTO_DESTROY name = ffStrbufCreate();
+    getSnapshotName(options, &name);
+    FF_STRBUF_AUTO_DESTROY content = ffStrbufCreate();
+    uint64_t time;
+    if (!ffSnapshotLoad(name.chars, options->snapshotMaxAge, &content, &time) || time >= time1)
+        return;
+
+    FF_AUTO_FREE FFNetIOResult* counters = malloc(ioCounters1.length * sizeof(*counters));
+    for (uint32_t i = 0; i < ioCounters1.length; ++i)
+    {
+        const FFNetIOResult* current = FF_LIST_GET(FFNetIOResult, ioCounters1, i);
+        counters[i] = *current;
+        if (!ffSnapshotFindCounters(&content, &counters[i].name, &counters[i], snapshotCounters, ARRAY_SIZE(snapshotCounters)))
+            return; // Interfaces changed
+
+        for (uint32_t j = 0; j < ARRAY_SIZE(snapshotCounters); ++j)
+        {
+            if (*(uint64_t*) ((uint8_t*) &counters[i] + snapshotCounters[j]) > *(const uint64_t*) ((const uint8_t*) current + snapshotCounters[j]))
+                return; // Counters have been reset, e.g. the interface was recreated
+        }
+    }
+
+    memcpy(ioCounters1.data, counters, ioCounters1.length * sizeof(*counters));
+    time1 = time;
+}
+
+static void saveSnapshot(const FFNetIOOptions* options, const FFlist* counters, uint64_t time)
+{
+    FF_STRBUF_AUTO_DESTROY name = ffStrbufCreate();
+    getSnapshotName(options, &name);
+    FF_STRBUF_AUTO_DESTROY content = ffStrbufCreate();
+    FF_LIST_FOR_EACH(FFNetIOResult, counter, *counters)
+        ffSnapshotAppendCounters(&content, &counter->name, counter, snapshotCounters, ARRAY_SIZE(snapshotCounters));
+    ffSnapshotSave(name.chars, time, &content);
+}
+
 void ffPrepareNetIO(FFNetIOOptions* options)
 {
     if (options->detectTotal) return;
@@ -23,6 +83,8 @@ const char* ffDetectNetIO(FFlist* result, FFNetIOOptions* options)
         error = ffNetIOGetIoCounters(result, options);
         if (error)
             return error;
+        if (options->snapshotMaxAge > 0)
+            saveSnapshot(options, result, ffTimeGetNow());
         return NULL;
     }
 
@@ -38,6 +100,9 @@ const char* ffDetectNetIO(FFlist* result, FFNetIOOptions* options)
     if (ioCounters1.length == 0)
         return "No network interfaces found";
 
+    if (options->snapshotMaxAge > 0)
+        loadSnapshot(options);
+
     uint64_t time2 = ffTimeGetNow();
     while (time2 - time1 < options->waitTime)
     {
@@ -52,6 +117,9 @@ const char* ffDetectNetIO(FFlist* result, FFNetIOOptions* options)
     if (result->length != ioCounters1.length)
         return "Different number of network interfaces. Network change?";
 
+    double elapsedMs = (double) (time2 - time1);
+    if (elapsedMs <= 0) elapsedMs = 1;
+    double seconds = elapsedMs / 1000;
     for (uint32_t i = 0; i < result->length; ++i)
     {
         FFNetIOResult* icPrev = FF_LIST_GET(FFNetIOResult, ioCounters1, i);
@@ -65,12 +133,14 @@ const char* ffDetectNetIO(FFlist* result, FFNetIOOptions* options)
             uint64_t* prevValue = (uint64_t*) ((uint8_t*) icPrev + off);
             uint64_t* currValue = (uint64_t*) ((uint8_t*) icCurr + off);
             uint64_t temp = *currValue;
-            *currValue -= *prevValue;
-            *currValue /= (time2 - time1) / 1000 /* seconds */;
+            *currValue = (uint64_t) ((double) (*currValue - *prevValue) / seconds);
             *prevValue = temp;
         }
     }
     time1 = time2;
 
+    if (options->snapshotMaxAge > 0)
+        saveSnapshot(options, &ioCounters1, time1);
+
     return NULL;
 }
@@ -5,6 +5,103 @@
 #include "util/stringUtils.h"
 
 #include <net/if.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <linux/if.h>
+#include <linux/if_link.h>
+
+#pragma GCC diagnostic ignored "-Wsign-conversion" // NLMSG_NEXT / RTA_NEXT
+
+static bool getDataNetlink(FFlist* result, FFNetIOOptions* options, const char* defaultRouteIfName)
+{
+    FF_AUTO_CLOSE_FD int sock = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+    if (sock < 0)
+        return false;
+
+    struct {
+        struct nlmsghdr nlh;
+        struct ifinfomsg ifi;
+    } req = {
+        .nlh = {
+            .nlmsg_len = NLMSG_LENGTH(sizeof(struct ifinfomsg)),
+            .nlmsg_type = RTM_GETLINK,
+            .nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP,
+            .nlmsg_seq = 1,
+        },
+        .ifi = {
+            .ifi_family = AF_UNSPEC,
+        },
+    };
+
+    if (options->defaultRouteOnly)
+    {
+        if (defaultRouteIfName[0] == '\0')
+            return true;
+
+        // Query the single interface instead of dumping all of them
+        req.nlh.nlmsg_flags = NLM_F_REQUEST;
+        req.ifi.ifi_index = (int) ffNetifGetDefaultRouteIfIndex();
+    }
+
+    FF_STRBUF_AUTO_DESTROY reply = ffStrbufCreate();
+    if (!ffNetlinkRequest(sock, &req, &reply))
+        return false;
+
+    int remaining = (int) reply.length;
+    for (struct nlmsghdr* nlh = (struct nlmsghdr*) reply.chars; NLMSG_OK(nlh, remaining); nlh = NLMSG_NEXT(nlh, remaining))
+    {
+        if (nlh->nlmsg_type != RTM_NEWLINK)
+            continue;
+
+        struct ifinfomsg* ifi = (struct ifinfomsg*) NLMSG_DATA(nlh);
+        const char* ifName = NULL;
+        bool up = false;
+        struct rtnl_link_stats64 stats;
+        bool hasStats = false;
+
+        int attrLen = (int) IFLA_PAYLOAD(nlh);
+        for (struct rtattr* rta = IFLA_RTA(ifi); RTA_OK(rta, attrLen); rta = RTA_NEXT(rta, attrLen))
+        {
+            switch (rta->rta_type)
+            {
+            case IFLA_IFNAME:
+                ifName = (const char*) RTA_DATA(rta);
+                break;
+            case IFLA_OPERSTATE:
+                up = *(uint8_t*) RTA_DATA(rta) == IF_OPER_UP;
+                break;
+            case IFLA_STATS64:
+                if (RTA_PAYLOAD(rta) < sizeof(stats))
+                    break;
+                // RTA_DATA is only 4-byte aligned
+                memcpy(&stats, RTA_DATA(rta), sizeof(stats));
+                hasStats = true;
+                break;
+            }
+        }
+
+        if (!ifName || !up || !hasStats)
+            continue;
+
+        if (options->namePrefix.length && strncmp(ifName, options->namePrefix.chars, options->namePrefix.length) != 0)
+            continue;
+
+        FFNetIOResult* counters = (FFNetIOResult*) ffListAdd(result);
+        ffStrbufInitS(&counters->name, ifName);
+        counters->defaultRoute = ffStrEquals(ifName, defaultRouteIfName);
+        counters->rxBytes = stats.rx_bytes;
+        counters->txBytes = stats.tx_bytes;
+        counters->rxPackets = stats.rx_packets;
+        counters->txPackets = stats.tx_packets;
+        counters->rxErrors = stats.rx_errors;
+        counters->txErrors = stats.tx_errors;
+        counters->rxDrops = stats.rx_dropped;
+        counters->txDrops = stats.tx_dropped;
+    }
+
+    return true;
+}
 
 static void getData(FFstrbuf* buffer, const char* ifName, bool isDefaultRoute, FFstrbuf* path, FFlist* result)
 {
@@ -62,20 +159,23 @@ static void getData(FFstrbuf* buffer, const char* ifName, bool isDefaultRoute, F
 
 const char* ffNetIOGetIoCounters(FFlist* result, FFNetIOOptions* options)
 {
+    const char* defaultRouteIfName = ffNetifGetDefaultRouteIfName();
+
+    if (options->defaultRouteOnly && options->namePrefix.length && strncmp(defaultRouteIfName, options->namePrefix.chars, options->namePrefix.length) != 0)
+        return NULL;
+
+    if (getDataNetlink(result, options, defaultRouteIfName))
+        return NULL;
+
     FF_AUTO_CLOSE_DIR DIR* dirp = opendir("/sys/class/net");
     if (!dirp) return "opendir(\"/sys/class/net\") == NULL";
 
     FF_STRBUF_AUTO_DESTROY path = ffStrbufCreateA(64);
     FF_STRBUF_AUTO_DESTROY buffer = ffStrbufCreate();
 
-    const char* defaultRouteIfName = ffNetifGetDefaultRouteIfName();
-
     if (options->defaultRouteOnly)
     {
-        if (options->namePrefix.length && strncmp(defaultRouteIfName, options->namePrefix.chars, options->namePrefix.length) != 0)
-            return NULL;
-
-       getData(&buffer, defaultRouteIfName, true, &path, result);
+        getData(&buffer, defaultRouteIfName, true, &path, result);
     }
     else
     {
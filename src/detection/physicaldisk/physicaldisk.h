@@ -20,6 +20,24 @@ typedef enum __attribute__((__packed__)) FFPhysicalDiskType
 } FFPhysicalDiskType;
 static_assert(sizeof(FFPhysicalDiskType) == sizeof(uint8_t), "");
 
+#define FF_PHYSICALDISK_HEALTH_UNSET UINT64_MAX
+
+// SMART telemetry. Fields are FF_PHYSICALDISK_HEALTH_UNSET if not available
+typedef struct FFPhysicalDiskHealth
+{
+    uint64_t percentageUsed; // Estimated life used; may exceed 100
+    uint64_t mediaErrors;
+    uint64_t powerOnHours;
+    uint64_t unsafeShutdowns;
+    uint64_t bytesRead;
+    uint64_t bytesWritten;
+} FFPhysicalDiskHealth;
+
+static inline void ffPhysicalDiskHealthReset(FFPhysicalDiskHealth* health)
+{
+    memset(health, 0xFF, sizeof(*health));
+}
+
 typedef struct FFPhysicalDiskResult
 {
     FFstrbuf name;
@@ -30,6 +48,7 @@ typedef struct FFPhysicalDiskResult
     FFPhysicalDiskType type;
     uint64_t size;
     double temperature;
+    FFPhysicalDiskHealth health;
 } FFPhysicalDiskResult;
 
 const char* ffDetectPhysicalDisk(FFlist* result, FFPhysicalDiskOptions* options);
@@ -80,6 +80,7 @@ const char* ffDetectPhysicalDisk(FFlist* result, FFPhysicalDiskOptions* options)
         device->type = FF_PHYSICALDISK_TYPE_NONE;
         device->size = 0;
         device->temperature = FF_PHYSICALDISK_TEMP_UNSET;
+        ffPhysicalDiskHealthReset(&device->health);
 
         FF_CFTYPE_AUTO_RELEASE CFBooleanRef removable = IORegistryEntryCreateCFProperty(entryPartition, CFSTR(kIOMediaRemovableKey), kCFAllocatorDefault, kNilOptions);
         if (removable)
@@ -88,6 +88,7 @@ const char* ffDetectPhysicalDisk(FFlist* result, FFPhysicalDiskOptions* options)
 
         device->type = type;
         device->temperature = FF_PHYSICALDISK_TEMP_UNSET;
+        ffPhysicalDiskHealthReset(&device->health);
     }
 
     geom_stats_snapshot_free(snap);
@@ -31,6 +31,7 @@ static const char* detectDisk(FFstrbuf* path, const char* diskType, FFlist* resu
     ffStrbufInit(&device->revision);
     ffStrbufInitS(&device->interconnect, diskType);
     device->temperature = FF_PHYSICALDISK_TEMP_UNSET;
+    ffPhysicalDiskHealthReset(&device->health);
     device->type = FF_PHYSICALDISK_TYPE_NONE;
     device->type |= (geometry.read_only ? FF_PHYSICALDISK_TYPE_READONLY : FF_PHYSICALDISK_TYPE_READWRITE) |
         (geometry.removable ? FF_PHYSICALDISK_TYPE_REMOVABLE : FF_PHYSICALDISK_TYPE_FIXED);
@@ -1,12 +1,17 @@
 #include "physicaldisk.h"
 #include "common/io/io.h"
 #include "common/properties.h"
+#include "common/snapshot.h"
+#include "common/time.h"
 #include "util/stringUtils.h"
 
 #include <ctype.h>
 #include <limits.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <sys/ioctl.h>
+#include <linux/nvme_ioctl.h>
+#include <scsi/sg.h>
 
 static double detectNvmeTemp(int devfd)
 {
@@ -157,6 +162,177 @@ static void parsePhysicalDisk(int dfd, const char* devName, FFPhysicalDiskOption
         device->temperature = detectNvmeTemp(devfd);
     else
         device->temperature = FF_PHYSICALDISK_TEMP_UNSET;
+
+    ffPhysicalDiskHealthReset(&device->health);
+}
+
+static inline uint64_t readLE(const uint8_t* p, uint32_t size)
+{
+    uint64_t value = 0;
+    for (uint32_t i = size; i > 0; --i)
+        value = value << 8 | p[i - 1];
+    return value;
+}
+
+// SMART / Health Information log page (02h)
+static bool detectNvmeHealth(int fd, FFPhysicalDiskHealth* health)
+{
+    uint8_t log[512];
+    struct nvme_admin_cmd cmd = {
+        .opcode = 0x02, // Get Log Page
+        .nsid = 0xFFFFFFFF, // Controller wide
+        .addr = (uint64_t) (uintptr_t) log,
+        .data_len = sizeof(log),
+        .cdw10 = 0x02 | (uint32_t) ((sizeof(log) / 4 - 1) << 16),
+    };
+    if (ioctl(fd, NVME_IOCTL_ADMIN_CMD, &cmd) != 0)
+        return false;
+
+    // 128 bit counters; the higher halves are not reachable in practice
+    health->percentageUsed = log[5];
+    health->bytesRead = readLE(log + 32, 8) * 512000; // In units of 1000 512-byte blocks
+    health->bytesWritten = readLE(log + 48, 8) * 512000;
+    health->powerOnHours = readLE(log + 128, 8);
+    health->unsafeShutdowns = readLE(log + 144, 8);
+    health->mediaErrors = readLE(log + 160, 8);
+    return true;
+}
+
+// SMART READ DATA through ATA PASS-THROUGH (16)
+static bool detectAtaHealth(int fd, FFPhysicalDiskHealth* health)
+{
+    uint8_t data[512] = {};
+    uint8_t sense[32];
+    uint8_t cdb[16] = {
+        [0] = 0x85, // ATA PASS-THROUGH (16)
+        [1] = 4 << 1, // PIO Data-In
+        [2] = 0x0e, // T_DIR = from device, BYT_BLOK = blocks, T_LENGTH = sector count
+        [4] = 0xd0, // Feature: SMART READ DATA
+        [6] = 1, // Sector count
+        [10] = 0x4f, // LBA mid
+        [12] = 0xc2, // LBA high
+        [14] = 0xb0, // Command: SMART
+    };
+    sg_io_hdr_t io = {
+        .interface_id = 'S',
+        .dxfer_direction = SG_DXFER_FROM_DEV,
+        .cmd_len = sizeof(cdb),
+        .mx_sb_len = sizeof(sense),
+        .dxfer_len = sizeof(data),
+        .dxferp = data,
+        .cmdp = cdb,
+        .sbp = sense,
+        .timeout = 3000,
+    };
+    if (ioctl(fd, SG_IO, &io) != 0 || io.status != 0 || io.host_status != 0 || io.driver_status != 0)
+        return false;
+
+    uint8_t checksum = 0;
+    for (uint32_t i = 0; i < sizeof(data); ++i)
+        checksum = (uint8_t) (checksum + data[i]);
+    if (checksum != 0)
+        return false;
+
+    // 30 vendor specific attributes of 12 bytes: id, flags (2), current, worst, raw (6), reserved
+    bool found = false;
+    for (const uint8_t* attr = data + 2; attr < data + 2 + 30 * 12; attr += 12)
+    {
+        uint8_t current = attr[3];
+        uint64_t raw = readLE(attr + 5, 6);
+        switch (attr[0])
+        {
+            case 9: // Power_On_Hours; some vendors store minutes in the higher bytes
+                health->powerOnHours = raw & 0xFFFFFFFF;
+                break;
+            case 174: // Unexpect_Power_Loss_Ct (SSD)
+                health->unsafeShutdowns = raw;
+                break;
+            case 192: // Power-Off_Retract_Count
+                if (health->unsafeShutdowns == FF_PHYSICALDISK_HEALTH_UNSET)
+                    health->unsafeShutdowns = raw;
+                break;
+            case 187: // Reported_Uncorrect
+                health->mediaErrors = raw;
+                break;
+            case 177: // Wear_Leveling_Count
+            case 202: // Percent_Lifetime_Remain
+            case 231: // SSD_Life_Left
+            case 233: // Media_Wearout_Indicator
+                if (current <= 100)
+                    health->percentageUsed = 100u - current;
+                break;
+            case 241: // Total_LBAs_Written
+                health->bytesWritten = raw * 512;
+                break;
+            case 242: // Total_LBAs_Read
+                health->bytesRead = raw * 512;
+                break;
+            default:
+                continue;
+        }
+        found = true;
+    }
+    return found;
+}
+
+static void detectHealth(FFPhysicalDiskResult* device)
+{
+    // Admin commands need (usually root) access to the device node
+    bool isNvme = ffStrbufEqualS(&device->interconnect, "NVMe");
+    if (!isNvme && !ffStrbufEqualS(&device->interconnect, "ATA"))
+        return;
+
+    FF_AUTO_CLOSE_FD int fd = open(device->devPath.chars, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0)
+        return;
+
+    if (isNvme)
+        detectNvmeHealth(fd, &device->health);
+    else
+        detectAtaHealth(fd, &device->health);
+}
+
+static const size_t healthFields[] = {
+    offsetof(FFPhysicalDiskHealth, percentageUsed),
+    offsetof(FFPhysicalDiskHealth, mediaErrors),
+    offsetof(FFPhysicalDiskHealth, powerOnHours),
+    offsetof(FFPhysicalDiskHealth, unsafeShutdowns),
+    offsetof(FFPhysicalDiskHealth, bytesRead),
+    offsetof(FFPhysicalDiskHealth, bytesWritten),
+};
+
+static inline const FFstrbuf* getHealthKey(const FFPhysicalDiskResult* device)
+{
+    return device->serial.length > 0 ? &device->serial : &device->devPath;
+}
+
+// Admin commands are comparatively expensive (and may spin up disks); reuse the results of recent runs
+static void detectAllHealth(FFlist* result, FFPhysicalDiskOptions* options)
+{
+    FF_STRBUF_AUTO_DESTROY content = ffStrbufCreate();
+    uint64_t time;
+    bool cached = options->healthTtl > 0 && ffSnapshotLoad("physicaldisk-health", options->healthTtl, &content, &time);
+
+    FF_LIST_FOR_EACH(FFPhysicalDiskResult, device, *result)
+    {
+        if (!cached)
+            break;
+        cached = ffSnapshotFindCounters(&content, getHealthKey(device), &device->health, healthFields, ARRAY_SIZE(healthFields));
+    }
+    if (cached)
+        return;
+
+    // Query all devices again, so that all cached entries have the same age
+    ffStrbufClear(&content);
+    FF_LIST_FOR_EACH(FFPhysicalDiskResult, device, *result)
+    {
+        ffPhysicalDiskHealthReset(&device->health);
+        detectHealth(device);
+        // Failures are cached too; no need to retry an inaccessible device on every run
+        ffSnapshotAppendCounters(&content, getHealthKey(device), &device->health, healthFields, ARRAY_SIZE(healthFields));
+    }
+    if (options->healthTtl > 0)
+        ffSnapshotSave("physicaldisk-health", ffTimeGetNow(), &content);
 }
 
 const char* ffDetectPhysicalDisk(FFlist* result, FFPhysicalDiskOptions* options)
@@ -180,5 +356,8 @@ const char* ffDetectPhysicalDisk(FFlist* result, FFPhysicalDiskOptions* options)
         if (dfd > 0) parsePhysicalDisk(dfd, devName, options, result);
     }
 
+    if (options->health && result->length > 0)
+        detectAllHealth(result, options);
+
     return NULL;
 }
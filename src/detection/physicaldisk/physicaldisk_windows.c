@@ -171,6 +171,7 @@ static bool detectPhysicalDisk(const wchar_t* szDevice, FFlist* result, FFPhysic
     }
 
     device->temperature = FF_PHYSICALDISK_TEMP_UNSET;
+    ffPhysicalDiskHealthReset(&device->health);
     if (options->temp)
     {
         STORAGE_TEMPERATURE_DATA_DESCRIPTOR stdd = {};
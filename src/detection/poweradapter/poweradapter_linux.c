@@ -1,5 +1,6 @@
 #include "poweradapter.h"
 #include "common/io/io.h"
+#include "common/properties.h"
 #include "util/stringUtils.h"
 
 #include <dirent.h>
@@ -8,30 +9,24 @@
 
 static void parsePowerAdapter(int dfd, FF_MAYBE_UNUSED const char* id, FFlist* results)
 {
+    FF_STRBUF_AUTO_DESTROY uevent = ffStrbufCreate();
+    ffReadFileBufferRelative(dfd, "uevent", &uevent);
+
     FF_STRBUF_AUTO_DESTROY tmpBuffer = ffStrbufCreate();
 
     //type must exist and be "Mains"
-    if (ffReadFileBufferRelative(dfd, "type", &tmpBuffer))
-        ffStrbufTrimRightSpace(&tmpBuffer);
-
-    if(!ffStrbufIgnCaseEqualS(&tmpBuffer, "Mains"))
+    if (!ffParsePropSysfsValue(dfd, &uevent, "POWER_SUPPLY_TYPE=", "type", &tmpBuffer) || !ffStrbufIgnCaseEqualS(&tmpBuffer, "Mains"))
         return;
 
     //scope may not exist or must not be "Device" (?)
-    if (ffReadFileBufferRelative(dfd, "scope", &tmpBuffer))
-        ffStrbufTrimRightSpace(&tmpBuffer);
-
-    if(ffStrbufIgnCaseEqualS(&tmpBuffer, "Device"))
+    if (ffParsePropSysfsValue(dfd, &uevent, "POWER_SUPPLY_SCOPE=", "scope", &tmpBuffer) && ffStrbufIgnCaseEqualS(&tmpBuffer, "Device"))
         return;
 
-    char online = '\0';
-    ffReadFileDataRelative(dfd, "online", sizeof(online), &online);
-
-    if (online != '1')
+    if (!ffParsePropSysfsValue(dfd, &uevent, "POWER_SUPPLY_ONLINE=", "online", &tmpBuffer) || !ffStrbufEqualS(&tmpBuffer, "1"))
         return;
 
     //input_power_limit must exist and be not empty
-    if (!ffReadFileBufferRelative(dfd, "input_power_limit", &tmpBuffer))
+    if (!ffParsePropSysfsValue(dfd, &uevent, "POWER_SUPPLY_INPUT_POWER_LIMIT=", "input_power_limit", &tmpBuffer) || tmpBuffer.length == 0)
         return;
 
     FFPowerAdapterResult* result = ffListAdd(results);
@@ -42,16 +37,11 @@ static void parsePowerAdapter(int dfd, FF_MAYBE_UNUSED const char* id, FFlist* r
     ffStrbufInit(&result->modelName);
     ffStrbufInit(&result->serial);
 
-    if (ffReadFileBufferRelative(dfd, "manufacturer", &result->manufacturer))
-        ffStrbufTrimRightSpace(&result->manufacturer);
-    else if (ffStrEquals(id, "macsmc-ac")) // asahi
+    if (!ffParsePropSysfsValue(dfd, &uevent, "POWER_SUPPLY_MANUFACTURER=", "manufacturer", &result->manufacturer) && ffStrEquals(id, "macsmc-ac")) // asahi
         ffStrbufSetStatic(&result->manufacturer, "Apple Inc.");
 
-    if (ffReadFileBufferRelative(dfd, "model_name", &result->modelName))
-        ffStrbufTrimRightSpace(&result->modelName);
-
-    if (ffReadFileBufferRelative(dfd, "serial_number", &result->serial))
-        ffStrbufTrimRightSpace(&result->serial);
+    ffParsePropSysfsValue(dfd, &uevent, "POWER_SUPPLY_MODEL_NAME=", "model_name", &result->modelName);
+    ffParsePropSysfsValue(dfd, &uevent, "POWER_SUPPLY_SERIAL_NUMBER=", "serial_number", &result->serial);
 }
 
 const char* ffDetectPowerAdapter(FFlist* results)
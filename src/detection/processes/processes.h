@@ -2,4 +2,12 @@
 
 #include "fastfetch.h"
 
-const char* ffDetectProcesses(uint32_t* result);
+typedef struct FFProcessesResult
+{
+    uint32_t processes; // 0 if not counted
+    uint32_t threads; // all tasks, including kernel threads; 0 if unknown
+    uint32_t running; // only detected if `runningBlocked` is set
+    uint32_t blocked;
+} FFProcessesResult;
+
+const char* ffDetectProcesses(FFProcessesOptions* options, bool runningBlocked, FFProcessesResult* result);
@@ -10,7 +10,7 @@
     #define KERN_PROC_PROC KERN_PROC_ALL // Apple
 #endif
 
-const char* ffDetectProcesses(uint32_t* result)
+const char* ffDetectProcesses(FF_MAYBE_UNUSED FFProcessesOptions* options, FF_MAYBE_UNUSED bool runningBlocked, FFProcessesResult* result)
 {
     int request[] = {CTL_KERN, KERN_PROC, KERN_PROC_PROC};
     size_t length;
@@ -18,6 +18,6 @@ const char* ffDetectProcesses(uint32_t* result)
     if(sysctl(request, ARRAY_SIZE(request), NULL, &length, NULL, 0) != 0)
         return "sysctl({CTL_KERN, KERN_PROC, KERN_PROC_PROC}) failed";
 
-    *result = (uint32_t)(length / sizeof(struct kinfo_proc));
+    result->processes = (uint32_t)(length / sizeof(struct kinfo_proc));
     return NULL;
 }
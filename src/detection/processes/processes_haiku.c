@@ -2,13 +2,14 @@
 
 #include <OS.h>
 
-const char* ffDetectProcesses(uint32_t* result)
+const char* ffDetectProcesses(FF_MAYBE_UNUSED FFProcessesOptions* options, FF_MAYBE_UNUSED bool runningBlocked, FFProcessesResult* result)
 {
     system_info info;
     if (get_system_info(&info) != B_OK)
         return "Error getting system info";
 
-    *result = info.used_teams;
+    result->processes = info.used_teams;
+    result->threads = info.used_threads;
 
     return NULL;
 }
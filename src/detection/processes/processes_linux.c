@@ -1,9 +1,94 @@
 #include "processes.h"
 
 #include "common/io/io.h"
+#include "util/mallocHelper.h"
 #include "util/stringUtils.h"
 
-const char* ffDetectProcesses(uint32_t* result)
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+struct FFLinuxDirent64
+{
+    uint64_t d_ino;
+    int64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[];
+};
+
+// readdir returns one entry per call; fetch them in large batches instead
+static const char* countProcesses(uint32_t* result)
+{
+    FF_AUTO_CLOSE_FD int dfd = open("/proc", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dfd < 0)
+        return "open(\"/proc\") failed";
+
+    enum { bufSize = 64 * 1024 };
+    FF_AUTO_FREE uint8_t* buf = malloc(bufSize);
+
+    uint32_t num = 0;
+    long nRead;
+    while ((nRead = syscall(SYS_getdents64, dfd, buf, bufSize)) > 0)
+    {
+        for (long pos = 0; pos < nRead; )
+        {
+            const struct FFLinuxDirent64* entry = (const struct FFLinuxDirent64*) (buf + pos);
+            if (entry->d_type == DT_DIR && ffCharIsDigit(entry->d_name[0]))
+                ++num;
+            pos += entry->d_reclen;
+        }
+    }
+    if (nRead < 0)
+        return "getdents64(\"/proc\") failed";
+
+    *result = num;
+    return NULL;
+}
+
+// "0.00 0.01 0.05 1/345 12345": the 4th field is runnable / total scheduling entities (threads)
+static bool detectTasks(FFProcessesResult* result)
+{
+    char buf[128];
+    ssize_t nRead = ffReadFileData("/proc/loadavg", ARRAY_SIZE(buf) - 1, buf);
+    if (nRead <= 0) return false;
+    buf[nRead] = '\0';
+
+    return sscanf(buf, "%*s %*s %*s %*u/%u", &result->threads) == 1;
+}
+
+static void detectRunningBlocked(FFProcessesResult* result)
+{
+    FF_STRBUF_AUTO_DESTROY buffer = ffStrbufCreate();
+    if (!ffReadFileBuffer("/proc/stat", &buffer))
+        return;
+
+    const char* token = strstr(buffer.chars, "\nprocs_running ");
+    if (token)
+        result->running = (uint32_t) strtoul(token + strlen("\nprocs_running "), NULL, 10);
+
+    token = strstr(buffer.chars, "\nprocs_blocked ");
+    if (token)
+        result->blocked = (uint32_t) strtoul(token + strlen("\nprocs_blocked "), NULL, 10);
+}
+
+const char* ffDetectProcesses(FFProcessesOptions* options, bool runningBlocked, FFProcessesResult* result)
+{
+    bool hasTasks = detectTasks(result);
+    // /proc/stat has one line per CPU and per IRQ; don't read it if not needed
+    if (runningBlocked)
+        detectRunningBlocked(result);
+
+    if (options->fast && hasTasks)
+        return NULL;
+
+    return countProcesses(&result->processes);
+}
+
+#else
+
+const char* ffDetectProcesses(FF_MAYBE_UNUSED FFProcessesOptions* options, FF_MAYBE_UNUSED bool runningBlocked, FFProcessesResult* result)
 {
     FF_AUTO_CLOSE_DIR DIR* dir = opendir("/proc");
     if(dir == NULL)
@@ -22,7 +107,9 @@ const char* ffDetectProcesses(uint32_t* result)
             ++num;
     }
 
-    *result = num;
+    result->processes = num;
 
     return NULL;
 }
+
+#endif
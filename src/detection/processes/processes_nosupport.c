@@ -1,6 +1,6 @@
 #include "processes.h"
 
-const char* ffDetectProcesses(uint32_t* result)
+const char* ffDetectProcesses(FF_MAYBE_UNUSED FFProcessesOptions* options, FF_MAYBE_UNUSED bool runningBlocked, FF_MAYBE_UNUSED FFProcessesResult* result)
 {
     return "Not supported on this platform";
 }
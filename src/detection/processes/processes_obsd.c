@@ -4,11 +4,13 @@
 #include <sys/sysctl.h>
 #include <kvm.h>
 
-const char* ffDetectProcesses(uint32_t* result)
+const char* ffDetectProcesses(FF_MAYBE_UNUSED FFProcessesOptions* options, FF_MAYBE_UNUSED bool runningBlocked, FFProcessesResult* result)
 {
     kvm_t* kd = kvm_open(NULL, NULL, NULL, KVM_NO_FILES, NULL);
-    const void* ret = kvm_getprocs(kd, KERN_PROC_ALL, 0, 1, result);
+    int count = 0;
+    const void* ret = kvm_getprocs(kd, KERN_PROC_ALL, 0, 1, &count);
     kvm_close(kd);
     if (!ret) return "kvm_getprocs() failed";
+    result->processes = (uint32_t) count;
     return NULL;
 }
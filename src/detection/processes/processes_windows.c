@@ -4,7 +4,7 @@
 #include <ntstatus.h>
 #include <winternl.h>
 
-const char* ffDetectProcesses(uint32_t* result)
+const char* ffDetectProcesses(FF_MAYBE_UNUSED FFProcessesOptions* options, FF_MAYBE_UNUSED bool runningBlocked, FFProcessesResult* result)
 {
     SYSTEM_PROCESS_INFORMATION* FF_AUTO_FREE pstart = NULL;
 
@@ -27,9 +27,13 @@ const char* ffDetectProcesses(uint32_t* result)
             return "NtQuerySystemInformation(SystemProcessInformation) failed";
     }
 
-    *result = 1; //Init with 1 because we test for ptr->NextEntryOffset
+    result->processes = 1; //Init with 1 because we test for ptr->NextEntryOffset
+    result->threads = (uint32_t) pstart->NumberOfThreads;
     for (SYSTEM_PROCESS_INFORMATION* ptr = pstart; ptr->NextEntryOffset; ptr = (SYSTEM_PROCESS_INFORMATION*)((uint8_t*)ptr + ptr->NextEntryOffset))
-        ++*result;
+    {
+        ++result->processes;
+        result->threads += (uint32_t) ((SYSTEM_PROCESS_INFORMATION*)((uint8_t*)ptr + ptr->NextEntryOffset))->NumberOfThreads;
+    }
 
     return NULL;
 }
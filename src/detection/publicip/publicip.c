@@ -1,32 +1,43 @@
 #include "publicip.h"
 #include "common/networking/networking.h"
+#include "common/netif/netif.h"
 
-#define FF_UNITIALIZED ((const char*)(uintptr_t) -1)
-static FFNetworkingState states[2];
-static const char* statuses[2] = { FF_UNITIALIZED, FF_UNITIALIZED };
+typedef struct FFPublicIpRequest
+{
+    FFNetworkingState state;
+    const char* status;
+    FFstrbuf cacheKey; // empty if caching is disabled
+    FFstrbuf cachedBody;
+    bool cached;
+} FFPublicIpRequest;
+
+// Requests issued by ffPreparePublicIp, consumed by ffDetectPublicIp in the same (module) order
+static FFlist requests = { .elementSize = sizeof(FFPublicIpRequest*) };
 
 void ffPreparePublicIp(FFPublicIpOptions* options)
 {
-    FFNetworkingState* state = &states[options->ipv6];
-    const char** status = &statuses[options->ipv6];
-    if (*status != FF_UNITIALIZED)
-    {
-        fputs("Error: PublicIp module can only be used once due to internal limitations\n", stderr);
-        exit(1);
-    }
+    FFPublicIpRequest* request = calloc(1, sizeof(*request));
+    *(FFPublicIpRequest**) ffListAdd(&requests) = request;
+    FFNetworkingState* state = &request->state;
+    ffStrbufInit(&request->cacheKey);
+    ffStrbufInit(&request->cachedBody);
 
     state->timeout = options->timeout;
     state->ipv6 = options->ipv6;
 
+    FF_STRBUF_AUTO_DESTROY host = ffStrbufCreate();
+    FF_STRBUF_AUTO_DESTROY path = ffStrbufCreate();
+
     if (options->url.length == 0)
     {
         state->compression = true;
         state->tfo = true;
-        *status = ffNetworkingSendHttpRequest(state, options->ipv6 ? "v6.ipinfo.io" : "ipinfo.io", "/json", NULL);
+        ffStrbufSetS(&host, options->ipv6 ? "v6.ipinfo.io" : "ipinfo.io");
+        ffStrbufSetS(&path, "/json");
     }
     else
     {
-        FF_STRBUF_AUTO_DESTROY host = ffStrbufCreateCopy(&options->url);
+        ffStrbufSet(&host, &options->url);
         uint32_t hostStartIndex = ffStrbufFirstIndexS(&host, "://");
         if (hostStartIndex < host.length)
         {
@@ -39,16 +50,42 @@ void ffPreparePublicIp(FFPublicIpOptions* options)
         }
         uint32_t pathStartIndex = ffStrbufFirstIndexC(&host, '/');
 
-        FF_STRBUF_AUTO_DESTROY path = ffStrbufCreate();
         if(pathStartIndex != host.length)
         {
-            ffStrbufAppendNS(&path, pathStartIndex, host.chars + (host.length - pathStartIndex));
+            ffStrbufAppendNS(&path, host.length - pathStartIndex, host.chars + pathStartIndex);
             host.length = pathStartIndex;
             host.chars[pathStartIndex] = '\0';
         }
+        if (path.length == 0)
+            ffStrbufSetS(&path, "/");
+    }
+
+    if (options->ttl > 0)
+    {
+        // The public IP usually changes only when we move to another network,
+        // so the addresses of the default route interface are part of the key
+        ffStrbufAppendF(&request->cacheKey, "%s%s ipv6=%d if=%u", host.chars, path.chars, options->ipv6, ffNetifGetDefaultRouteIfIndex());
+        #ifndef _WIN32
+        ffNetifAppendDefaultRouteIfAddresses(&request->cacheKey);
+        #endif
 
-        *status = ffNetworkingSendHttpRequest(state, host.chars, path.length == 0 ? "/" : path.chars, NULL);
+        if (ffNetworkingCacheRead(request->cacheKey.chars, options->ttl, &request->cachedBody))
+        {
+            request->cached = true;
+            return;
+        }
     }
+
+    request->status = ffNetworkingSendHttpRequest(state, host.chars, path.chars, NULL);
+}
+
+static void freeRequest(FFPublicIpRequest** prequest)
+{
+    FFPublicIpRequest* request = *prequest;
+    if (!request) return;
+    ffStrbufDestroy(&request->cacheKey);
+    ffStrbufDestroy(&request->cachedBody);
+    free(request);
 }
 
 static inline void wrapYyjsonFree(yyjson_doc** doc)
@@ -60,23 +97,30 @@ static inline void wrapYyjsonFree(yyjson_doc** doc)
 
 const char* ffDetectPublicIp(FFPublicIpOptions* options, FFPublicIpResult* result)
 {
-    FFNetworkingState* state = &states[options->ipv6];
-    const char** status = &statuses[options->ipv6];
-    if (*status == FF_UNITIALIZED)
+    if (requests.length == 0)
         ffPreparePublicIp(options);
 
-    if (*status != NULL)
-        return *status;
+    __attribute__((__cleanup__(freeRequest))) FFPublicIpRequest* request = NULL;
+    ffListShift(&requests, &request);
 
-    FF_STRBUF_AUTO_DESTROY response = ffStrbufCreateA(4096);
-    const char* error = ffNetworkingRecvHttpResponse(state, &response);
-    if (error == NULL)
-        ffStrbufSubstrAfterFirstS(&response, "\r\n\r\n");
+    FF_STRBUF_AUTO_DESTROY response = ffStrbufCreate();
+    if (request->cached)
+        ffStrbufInitMove(&response, &request->cachedBody);
     else
-        return error;
+    {
+        if (request->status != NULL)
+            return request->status;
+
+        const char* error = ffNetworkingRecvHttpResponse(&request->state, &response);
+        if (error != NULL)
+            return error;
 
-    if (response.length == 0)
-        return "Empty server response received";
+        if (response.length == 0)
+            return "Empty server response received";
+
+        if (request->cacheKey.length > 0)
+            ffNetworkingCacheWrite(request->cacheKey.chars, &response);
+    }
 
     if (options->url.length == 0)
     {
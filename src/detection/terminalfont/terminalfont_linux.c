@@ -302,13 +302,24 @@ static bool extractStTermFont(const char* str, FF_MAYBE_UNUSED uint32_t len, voi
 
 static void detectSt(FFTerminalFontResult* terminalFont, const FFTerminalResult* terminal)
 {
-    FF_STRBUF_AUTO_DESTROY size = ffStrbufCreateF("/proc/%u/cmdline", terminal->pid);
+    FF_STRBUF_AUTO_DESTROY size = ffStrbufCreate();
     FF_STRBUF_AUTO_DESTROY font = ffStrbufCreate();
+    #ifdef __linux__
+    const FFProcessEntry* entry = ffProcessTableGet((pid_t) terminal->pid, FF_PROCESS_ENTRY_CMDLINE);
+    if (!entry || entry->cmdline.length == 0)
+    {
+        ffStrbufAppendF(&terminalFont->error, "Failed to open /proc/%u/cmdline", terminal->pid);
+        return;
+    }
+    ffStrbufSet(&font, &entry->cmdline);
+    #else
+    ffStrbufSetF(&size, "/proc/%u/cmdline", terminal->pid);
     if (!ffAppendFileBuffer(size.chars, &font))
     {
         ffStrbufAppendF(&terminalFont->error, "Failed to open %s", size.chars);
         return;
     }
+    #endif
 
     const char* p = memmem(font.chars, font.length, "\0-f", sizeof("\0-f")); // find parameter of `-f`
     if (p)
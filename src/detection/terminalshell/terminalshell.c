@@ -383,7 +383,7 @@ FF_MAYBE_UNUSED static bool getTerminalVersionKonsole(FFstrbuf* exe, FFstrbuf* v
 FF_MAYBE_UNUSED static bool getTerminalVersionFoot(FFstrbuf* exe, FFstrbuf* version)
 {
     uint32_t major = 0, minor = 0, patch = 0;
-    if (ffGetTerminalResponse("\e[>c", 3, "\e[>1;%2u%2u%2u;0c", &major, &minor, &patch) == NULL)
+    if (ffGetTerminalResponseCached(false, "\e[>c", 3, "\e[>1;%2u%2u%2u;0c", &major, &minor, &patch) == NULL)
     {
         ffStrbufSetF(version, "%u.%u.%u", major, minor, patch);
         return true;
@@ -637,7 +637,7 @@ static bool getTerminalVersionKitty(FFstrbuf* exe, FFstrbuf* version)
 
     char versionHex[64];
     // https://github.com/fastfetch-cli/fastfetch/discussions/1030#discussioncomment-9845233
-    if (ffGetTerminalResponse(
+    if (ffGetTerminalResponseCached(false,
         "\eP+q6b697474792d71756572792d76657273696f6e\e\\", // kitty-query-version
         1,
         "\eP1+r%*[^=]=%63[^\e]\e\\\\", versionHex) == NULL)
@@ -18,11 +18,26 @@ bool ffDetectTerminalSize(FFTerminalSizeResult* result)
 
     ioctl(ttyfd, TIOCGWINSZ, &winsize);
 
+    // Ask for cells and pixels in one round trip
+    FFTerminalQuery queries[2];
+    uint32_t count = 0;
     if (winsize.ws_row == 0 || winsize.ws_col == 0)
-        ffGetTerminalResponse("\e[18t", 2, "\e[8;%hu;%hut", &winsize.ws_row, &winsize.ws_col);
-
+        queries[count++] = (FFTerminalQuery) { .request = "\e[18t", .responsePrefix = "\e[8;", .response = ffStrbufCreate() };
     if (winsize.ws_ypixel == 0 || winsize.ws_xpixel == 0)
-        ffGetTerminalResponse("\e[14t", 2, "\e[4;%hu;%hut", &winsize.ws_ypixel, &winsize.ws_xpixel);
+        queries[count++] = (FFTerminalQuery) { .request = "\e[14t", .responsePrefix = "\e[4;", .response = ffStrbufCreate() };
+
+    if (count > 0 && ffGetTerminalResponses(queries, count) == NULL)
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (queries[i].responsePrefix[2] == '8')
+                sscanf(queries[i].response.chars, "\e[8;%hu;%hut", &winsize.ws_row, &winsize.ws_col);
+            else
+                sscanf(queries[i].response.chars, "\e[4;%hu;%hut", &winsize.ws_ypixel, &winsize.ws_xpixel);
+        }
+    }
+    for (uint32_t i = 0; i < count; ++i)
+        ffStrbufDestroy(&queries[i].response);
 
     if (winsize.ws_row == 0 && winsize.ws_col == 0)
         return false;
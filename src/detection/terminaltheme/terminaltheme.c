@@ -4,10 +4,10 @@
 
 #include <inttypes.h>
 
-static bool detectByEscapeCode(FFTerminalThemeResult* result)
+static bool detectByEscapeCode(FFTerminalThemeResult* result, bool cacheOnly)
 {
     // Windows Terminal removes all `\e`s in its output
-    if (ffGetTerminalResponse("\e]10;?\e\\" /*fg*/ "\e]11;?\e\\" /*bg*/,
+    if (ffGetTerminalResponseCached(cacheOnly, "\e]10;?\e\\" /*fg*/ "\e]11;?\e\\" /*bg*/,
         6,
         "%*[^0-9]10;rgb:%" SCNx16 "/%" SCNx16 "/%" SCNx16 /*"\e\\"*/ "%*[^0-9]11;rgb:%" SCNx16 "/%" SCNx16 "/%" SCNx16 /*"\e\\"*/,
         &result->fg.r, &result->fg.g, &result->fg.b,
@@ -69,7 +69,8 @@ static bool detectByEnv(FFTerminalThemeResult* result)
 
 static inline bool detectColor(FFTerminalThemeResult* result, bool forceEnv)
 {
-    if (!forceEnv && detectByEscapeCode(result))
+    // Even when forced to avoid querying the terminal, a reply cached by a previous run is more accurate than env
+    if (detectByEscapeCode(result, forceEnv))
         return true;
 
     return detectByEnv(result);
@@ -1,19 +1,27 @@
 #include "weather.h"
 #include "common/networking/networking.h"
 
-#define FF_UNITIALIZED ((const char*)(uintptr_t) -1)
-static FFNetworkingState state;
-static const char* status = FF_UNITIALIZED;
+typedef struct FFWeatherRequest
+{
+    FFNetworkingState state;
+    const char* status;
+    FFstrbuf cacheKey; // empty if caching is disabled
+    FFstrbuf cachedBody;
+    bool cached;
+} FFWeatherRequest;
+
+// Requests issued by ffPrepareWeather, consumed by ffDetectWeather in the same (module) order
+static FFlist requests = { .elementSize = sizeof(FFWeatherRequest*) };
 
 void ffPrepareWeather(FFWeatherOptions* options)
 {
-    if (status != FF_UNITIALIZED)
-    {
-        fputs("Error: Weather module can only be used once due to internal limitations\n", stderr);
-        exit(1);
-    }
+    FFWeatherRequest* request = calloc(1, sizeof(*request));
+    *(FFWeatherRequest**) ffListAdd(&requests) = request;
+    ffStrbufInit(&request->cacheKey);
+    ffStrbufInit(&request->cachedBody);
 
-    state.timeout = options->timeout;
+    request->state.timeout = options->timeout;
+    request->state.dualStack = true;
 
     FF_STRBUF_AUTO_DESTROY path = ffStrbufCreateS("/");
     if (options->location.length)
@@ -31,29 +39,57 @@ void ffPrepareWeather(FFWeatherOptions* options)
         default:
             break;
     }
-    status = ffNetworkingSendHttpRequest(&state, "wttr.in", path.chars, "User-Agent: curl/0.0.0\r\n");
+
+    if (options->ttl > 0)
+    {
+        ffStrbufAppendF(&request->cacheKey, "wttr.in%s", path.chars);
+        if (ffNetworkingCacheRead(request->cacheKey.chars, options->ttl, &request->cachedBody))
+        {
+            request->cached = true;
+            return;
+        }
+    }
+
+    request->status = ffNetworkingSendHttpRequest(&request->state, "wttr.in", path.chars, "User-Agent: curl/0.0.0\r\n");
+}
+
+static void freeRequest(FFWeatherRequest** prequest)
+{
+    FFWeatherRequest* request = *prequest;
+    if (!request) return;
+    ffStrbufDestroy(&request->cacheKey);
+    ffStrbufDestroy(&request->cachedBody);
+    free(request);
 }
 
 const char* ffDetectWeather(FFWeatherOptions* options, FFstrbuf* result)
 {
-    if(status == FF_UNITIALIZED)
+    if(requests.length == 0)
         ffPrepareWeather(options);
 
-    if(status != NULL)
-        return status;
+    __attribute__((__cleanup__(freeRequest))) FFWeatherRequest* request = NULL;
+    ffListShift(&requests, &request);
 
-    ffStrbufEnsureFree(result, 4095);
-    const char* error = ffNetworkingRecvHttpResponse(&state, result);
-    if (error == NULL)
+    if(request->cached)
     {
-        ffStrbufSubstrAfterFirstS(result, "\r\n\r\n");
-        ffStrbufTrimRightSpace(result);
+        ffStrbufDestroy(result);
+        ffStrbufInitMove(result, &request->cachedBody);
+        return NULL;
     }
-    else
+
+    if(request->status != NULL)
+        return request->status;
+
+    const char* error = ffNetworkingRecvHttpResponse(&request->state, result);
+    if (error != NULL)
         return error;
+    ffStrbufTrimRightSpace(result);
 
     if(result->length == 0)
         return "Empty server response received";
 
+    if(request->cacheKey.length > 0)
+        ffNetworkingCacheWrite(request->cacheKey.chars, result);
+
     return NULL;
 }
@@ -3,6 +3,7 @@
 #include "common/io/io.h"
 #include "common/processing.h"
 #include "common/properties.h"
+#include "common/netif/netif.h"
 #include "util/stringUtils.h"
 
 #include <net/if.h>
@@ -184,6 +185,294 @@ static const char* detectWifiWithNm(FFWifiResult* item, FFstrbuf* buffer)
 }
 #endif // FF_HAVE_DBUS
 
+#if __has_include(<linux/nl80211.h>)
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/genetlink.h>
+#include <linux/rtnetlink.h>
+#include <linux/nl80211.h>
+#include <linux/version.h>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wsign-conversion" // NLMSG_NEXT / RTA_NEXT
+
+static bool nl80211Request(int sock, uint16_t familyId, uint8_t cmd, bool dump, uint32_t ifIndex, FFstrbuf* reply)
+{
+    static uint32_t seq = 0;
+    struct {
+        struct nlmsghdr nlh;
+        struct genlmsghdr genl;
+        struct rtattr ifIndexAttr;
+        uint32_t ifIndex;
+    } req = {
+        .nlh = {
+            .nlmsg_len = sizeof(req),
+            .nlmsg_type = familyId,
+            .nlmsg_flags = (uint16_t) (NLM_F_REQUEST | (dump ? NLM_F_DUMP : 0)),
+            .nlmsg_seq = ++seq,
+        },
+        .genl = {
+            .cmd = cmd,
+        },
+        .ifIndexAttr = {
+            .rta_len = RTA_LENGTH(sizeof(uint32_t)),
+            .rta_type = NL80211_ATTR_IFINDEX,
+        },
+        .ifIndex = ifIndex,
+    };
+    return ffNetlinkRequest(sock, &req, reply);
+}
+
+static void parseRateInfo(const struct rtattr* rateInfo, double* rate, FFstrbuf* protocol)
+{
+    uint32_t bitrate = 0;
+    int attrLen = (int) RTA_PAYLOAD(rateInfo);
+    for (struct rtattr* rta = (struct rtattr*) RTA_DATA(rateInfo); RTA_OK(rta, attrLen); rta = RTA_NEXT(rta, attrLen))
+    {
+        switch (rta->rta_type)
+        {
+        case NL80211_RATE_INFO_BITRATE32:
+            bitrate = *(uint32_t*) RTA_DATA(rta);
+            break;
+        case NL80211_RATE_INFO_BITRATE:
+            if (bitrate == 0)
+                bitrate = *(uint16_t*) RTA_DATA(rta);
+            break;
+        }
+
+        if (!protocol)
+            continue;
+        switch (rta->rta_type)
+        {
+        #if LINUX_VERSION_CODE >= KERNEL_VERSION(6, 0, 0)
+        case NL80211_RATE_INFO_EHT_MCS:
+            ffStrbufSetStatic(protocol, "802.11be (Wi-Fi 7)");
+            break;
+        #endif
+        case NL80211_RATE_INFO_HE_MCS:
+            ffStrbufSetStatic(protocol, "802.11ax (Wi-Fi 6)");
+            break;
+        case NL80211_RATE_INFO_VHT_MCS:
+            ffStrbufSetStatic(protocol, "802.11ac (Wi-Fi 5)");
+            break;
+        case NL80211_RATE_INFO_MCS:
+            ffStrbufSetStatic(protocol, "802.11n (Wi-Fi 4)");
+            break;
+        }
+    }
+    if (bitrate > 0)
+        *rate = bitrate / 10.; // 100 kbit/s -> Mbit/s
+}
+
+static void parseSecurity(const uint8_t* ies, uint32_t length, bool privacy, FFWifiResult* item)
+{
+    bool wpa = false, rsnPsk = false, rsn8021x = false, rsnSae = false, rsnOwe = false, wpa8021x = false;
+
+    for (uint32_t i = 0; i + 2 <= length && i + 2u + ies[i + 1] <= length; i += 2u + ies[i + 1])
+    {
+        uint8_t id = ies[i], len = ies[i + 1];
+        const uint8_t* data = ies + i + 2;
+
+        if (id == 0 /* SSID */ && !item->conn.ssid.length)
+            ffStrbufSetNS(&item->conn.ssid, len, (const char*) data);
+        else if (id == 48 /* RSN */ && len >= 8)
+        {
+            // version(2) group cipher(4) pairwise count(2) pairwise suites(4n) akm count(2) akm suites(4m)
+            uint32_t off = 6;
+            uint16_t count = (uint16_t) (data[off] | data[off + 1] << 8);
+            off += 2 + 4u * count;
+            if (off + 2 > len) continue;
+            count = (uint16_t) (data[off] | data[off + 1] << 8);
+            off += 2;
+            for (uint16_t j = 0; j < count && off + 4 <= len; ++j, off += 4)
+            {
+                if (data[off] != 0x00 || data[off + 1] != 0x0F || data[off + 2] != 0xAC)
+                    continue;
+                switch (data[off + 3])
+                {
+                case 1: case 3: case 5: case 11: case 12: case 13:
+                    rsn8021x = true; break;
+                case 2: case 4: case 6:
+                    rsnPsk = true; break;
+                case 8: case 9: case 24: case 25:
+                    rsnSae = true; break;
+                case 18:
+                    rsnOwe = true; break;
+                }
+            }
+        }
+        else if (id == 221 /* Vendor specific */ && len >= 4 && data[0] == 0x00 && data[1] == 0x50 && data[2] == 0xF2 && data[3] == 1 /* WPA */)
+        {
+            wpa = true;
+            // OUI(3) type(1) version(2) group cipher(4) pairwise count(2) pairwise suites(4n) akm count(2) akm suites(4m)
+            uint32_t off = 10;
+            if (off + 2 > len) continue;
+            uint16_t count = (uint16_t) (data[off] | data[off + 1] << 8);
+            off += 2 + 4u * count;
+            if (off + 2 > len) continue;
+            count = (uint16_t) (data[off] | data[off + 1] << 8);
+            off += 2;
+            for (uint16_t j = 0; j < count && off + 4 <= len; ++j, off += 4)
+            {
+                if (data[off + 3] == 1)
+                    wpa8021x = true;
+            }
+        }
+    }
+
+    // Same naming as detectWifiWithNm
+    if (privacy && !wpa && !rsnPsk && !rsn8021x && !rsnSae && !rsnOwe)
+        ffStrbufAppendS(&item->conn.security, "WEP/");
+    if (wpa)
+        ffStrbufAppendS(&item->conn.security, "WPA/");
+    if (rsnPsk || rsn8021x)
+        ffStrbufAppendS(&item->conn.security, "WPA2/");
+    if (rsnSae)
+        ffStrbufAppendS(&item->conn.security, "WPA3/");
+    if (rsnOwe)
+        ffStrbufAppendS(&item->conn.security, "OWE/");
+    if (wpa8021x || rsn8021x)
+        ffStrbufAppendS(&item->conn.security, "802.1X/");
+    if (!item->conn.security.length)
+        ffStrbufAppendS(&item->conn.security, "Insecure");
+    else
+        ffStrbufTrimRight(&item->conn.security, '/');
+}
+
+static const char* detectWifiWithNl80211(FFWifiResult* item, uint32_t ifIndex)
+{
+    FF_AUTO_CLOSE_FD int sock = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_GENERIC);
+    if (sock < 0)
+        return "socket(AF_NETLINK) failed";
+
+    uint16_t familyId = ffNetlinkGetGenlFamily(sock, NL80211_GENL_NAME);
+    if (familyId == 0)
+        return "nl80211 is not available";
+
+    FF_STRBUF_AUTO_DESTROY reply = ffStrbufCreate();
+
+    // Interface: SSID and operating frequency
+    if (!nl80211Request(sock, familyId, NL80211_CMD_GET_INTERFACE, false, ifIndex, &reply))
+        return "NL80211_CMD_GET_INTERFACE failed";
+
+    int remaining = (int) reply.length;
+    for (struct nlmsghdr* nlh = (struct nlmsghdr*) reply.chars; NLMSG_OK(nlh, remaining); nlh = NLMSG_NEXT(nlh, remaining))
+    {
+        if (nlh->nlmsg_type != familyId) continue;
+        int attrLen = (int) NLMSG_PAYLOAD(nlh, GENL_HDRLEN);
+        for (struct rtattr* rta = (struct rtattr*) ((uint8_t*) NLMSG_DATA(nlh) + GENL_HDRLEN); RTA_OK(rta, attrLen); rta = RTA_NEXT(rta, attrLen))
+        {
+            if (rta->rta_type == NL80211_ATTR_SSID)
+                ffStrbufSetNS(&item->conn.ssid, (uint32_t) RTA_PAYLOAD(rta), (const char*) RTA_DATA(rta));
+            else if (rta->rta_type == NL80211_ATTR_WIPHY_FREQ)
+                item->conn.frequency = (uint16_t) *(uint32_t*) RTA_DATA(rta);
+        }
+    }
+
+    // Station: for a managed interface, the only station is the AP we are associated with
+    if (!nl80211Request(sock, familyId, NL80211_CMD_GET_STATION, true, ifIndex, &reply))
+    {
+        ffStrbufClear(&item->conn.ssid);
+        item->conn.frequency = 0;
+        return "NL80211_CMD_GET_STATION failed";
+    }
+
+    remaining = (int) reply.length;
+    for (struct nlmsghdr* nlh = (struct nlmsghdr*) reply.chars; NLMSG_OK(nlh, remaining); nlh = NLMSG_NEXT(nlh, remaining))
+    {
+        if (nlh->nlmsg_type != familyId || item->conn.bssid.length) continue;
+        int attrLen = (int) NLMSG_PAYLOAD(nlh, GENL_HDRLEN);
+        for (struct rtattr* rta = (struct rtattr*) ((uint8_t*) NLMSG_DATA(nlh) + GENL_HDRLEN); RTA_OK(rta, attrLen); rta = RTA_NEXT(rta, attrLen))
+        {
+            if (rta->rta_type == NL80211_ATTR_MAC && RTA_PAYLOAD(rta) >= 6)
+            {
+                const uint8_t* mac = (const uint8_t*) RTA_DATA(rta);
+                ffStrbufSetF(&item->conn.bssid, "%02X:%02X:%02X:%02X:%02X:%02X", mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+            }
+            else if (rta->rta_type == NL80211_ATTR_STA_INFO)
+            {
+                int nestLen = (int) RTA_PAYLOAD(rta);
+                for (struct rtattr* info = (struct rtattr*) RTA_DATA(rta); RTA_OK(info, nestLen); info = RTA_NEXT(info, nestLen))
+                {
+                    switch (info->rta_type)
+                    {
+                    case NL80211_STA_INFO_SIGNAL: {
+                        int8_t level = *(int8_t*) RTA_DATA(info);
+                        item->conn.signalQuality = level >= -50 ? 100 : level <= -100 ? 0 : (level + 100) * 2;
+                        break;
+                    }
+                    case NL80211_STA_INFO_TX_BITRATE:
+                        parseRateInfo(info, &item->conn.txRate, &item->conn.protocol);
+                        break;
+                    case NL80211_STA_INFO_RX_BITRATE:
+                        parseRateInfo(info, &item->conn.rxRate, NULL);
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    if (!item->conn.bssid.length)
+    {
+        ffStrbufSetStatic(&item->conn.status, "disconnected");
+        return NULL;
+    }
+    ffStrbufSetStatic(&item->conn.status, "connected");
+
+    // Scan results: security (and SSID on old kernels) of the associated BSS, from cached data without triggering a scan
+    if (nl80211Request(sock, familyId, NL80211_CMD_GET_SCAN, true, ifIndex, &reply))
+    {
+        remaining = (int) reply.length;
+        for (struct nlmsghdr* nlh = (struct nlmsghdr*) reply.chars; NLMSG_OK(nlh, remaining); nlh = NLMSG_NEXT(nlh, remaining))
+        {
+            if (nlh->nlmsg_type != familyId) continue;
+            int attrLen = (int) NLMSG_PAYLOAD(nlh, GENL_HDRLEN);
+            for (struct rtattr* rta = (struct rtattr*) ((uint8_t*) NLMSG_DATA(nlh) + GENL_HDRLEN); RTA_OK(rta, attrLen); rta = RTA_NEXT(rta, attrLen))
+            {
+                if (rta->rta_type != NL80211_ATTR_BSS) continue;
+
+                bool associated = false, privacy = false;
+                const uint8_t* ies = NULL;
+                uint32_t iesLength = 0, frequency = 0;
+                int nestLen = (int) RTA_PAYLOAD(rta);
+                for (struct rtattr* bss = (struct rtattr*) RTA_DATA(rta); RTA_OK(bss, nestLen); bss = RTA_NEXT(bss, nestLen))
+                {
+                    switch (bss->rta_type)
+                    {
+                    case NL80211_BSS_STATUS:
+                        associated = *(uint32_t*) RTA_DATA(bss) == NL80211_BSS_STATUS_ASSOCIATED;
+                        break;
+                    case NL80211_BSS_CAPABILITY:
+                        privacy = !!(*(uint16_t*) RTA_DATA(bss) & (1 << 4));
+                        break;
+                    case NL80211_BSS_FREQUENCY:
+                        frequency = *(uint32_t*) RTA_DATA(bss);
+                        break;
+                    case NL80211_BSS_INFORMATION_ELEMENTS:
+                        ies = (const uint8_t*) RTA_DATA(bss);
+                        iesLength = (uint32_t) RTA_PAYLOAD(bss);
+                        break;
+                    }
+                }
+                if (!associated) continue;
+
+                if (item->conn.frequency == 0)
+                    item->conn.frequency = (uint16_t) frequency;
+                parseSecurity(ies, ies ? iesLength : 0, privacy, item);
+            }
+        }
+    }
+
+    if (item->conn.frequency > 0)
+        item->conn.channel = ffWifiFreqToChannel(item->conn.frequency);
+
+    return NULL;
+}
+
+#pragma GCC diagnostic pop
+#endif
+
 static const char* detectWifiWithIw(FFWifiResult* item, FFstrbuf* buffer)
 {
     const char* error = NULL;
@@ -396,6 +685,11 @@ const char* ffDetectWifi(FF_MAYBE_UNUSED FFlist* result)
         if (!ffStrbufEqualS(&item->inf.status, "up"))
             continue;
 
+        #if __has_include(<linux/nl80211.h>)
+        if (detectWifiWithNl80211(item, i->if_index) == NULL)
+            continue;
+        #endif
+
         if (detectWifiWithIw(item, &buffer) != NULL)
         {
             #ifdef FF_HAVE_LINUX_WIRELESS
@@ -1,5 +1,214 @@
 #include "zpool.h"
 
+#ifdef __linux__
+#include "common/io/io.h"
+#include "util/stringUtils.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+
+// Reading pool properties directly from /dev/zfs avoids `libzfs_init`,
+// which imports the state of all pools and can take hundreds of milliseconds.
+
+#define FF_ZFS_IOC_POOL_GET_PROPS (('Z' << 8) + 0x27)
+
+// Leading part of `zfs_cmd_t`, which is stable across OpenZFS versions.
+// The kernel copies in and out `sizeof(zfs_cmd_t)` bytes, so it must be embedded into a larger buffer
+typedef struct FFZfsCmd
+{
+    char name[4096];
+    uint64_t nvlistSrc;
+    uint64_t nvlistSrcSize;
+    uint64_t nvlistDst;
+    uint64_t nvlistDstSize;
+    int32_t nvlistDstFilled;
+    int32_t pad;
+} FFZfsCmd;
+
+// Native nvlist encoding (see nvpair.c of OpenZFS)
+enum
+{
+    FF_NV_TYPE_UINT64 = 8,
+    FF_NV_TYPE_NVLIST = 19,
+    FF_NV_TYPE_NVLIST_ARRAY = 20,
+};
+
+typedef struct FFNvPair
+{
+    int32_t type;
+    const uint8_t* value;
+    const uint8_t* valueEnd;
+    const uint8_t* nested; // the encoded nvlist following the pair, if type is FF_NV_TYPE_NVLIST
+} FFNvPair;
+
+// Walks the encoded nvlist at *pp, moving *pp past its end. Stores the pair named `key` into `found`
+static bool nvWalk(const uint8_t** pp, const uint8_t* end, const char* key, FFNvPair* found)
+{
+    const uint8_t* p = *pp;
+    if (end - p < 8) return false;
+    p += 8; // nvl_version, nvl_nvflag
+
+    while (true)
+    {
+        if (end - p < 4) return false;
+        int32_t size;
+        memcpy(&size, p, sizeof(size));
+        if (size == 0)
+        {
+            p += 4;
+            break;
+        }
+        if (size < 24 || end - p < size) return false;
+
+        int16_t nameSize;
+        int32_t nelem, type;
+        memcpy(&nameSize, p + 4, sizeof(nameSize));
+        memcpy(&nelem, p + 8, sizeof(nelem));
+        memcpy(&type, p + 12, sizeof(type));
+        if (nameSize <= 0 || 16 + nameSize > size || p[16 + nameSize - 1] != '\0')
+            return false;
+
+        const char* name = (const char*) (p + 16);
+        bool match = key && ffStrEquals(name, key);
+        if (match)
+        {
+            found->type = type;
+            found->value = p + 16 + ((nameSize + 7) & ~7);
+            found->valueEnd = p + size;
+            found->nested = NULL;
+        }
+        p += size;
+
+        // Embedded nvlists are encoded right after the pair
+        if (type == FF_NV_TYPE_NVLIST || type == FF_NV_TYPE_NVLIST_ARRAY)
+        {
+            int32_t count = type == FF_NV_TYPE_NVLIST ? 1 : nelem;
+            for (int32_t i = 0; i < count; ++i)
+            {
+                if (match && i == 0) found->nested = p;
+                if (!nvWalk(&p, end, NULL, NULL)) return false;
+            }
+        }
+    }
+
+    *pp = p;
+    return true;
+}
+
+// Pool properties are encoded as { "<prop>": { "value": <value>, "source": <source> } }
+static bool getPropUint64(const uint8_t* props, const uint8_t* end, const char* name, uint64_t* result)
+{
+    FFNvPair pair = {};
+    if (!nvWalk(&props, end, name, &pair) || pair.type != FF_NV_TYPE_NVLIST || !pair.nested)
+        return false;
+
+    const uint8_t* nested = pair.nested;
+    pair = (FFNvPair) {};
+    if (!nvWalk(&nested, end, "value", &pair) || pair.type != FF_NV_TYPE_UINT64 || pair.valueEnd - pair.value < (ptrdiff_t) sizeof(*result))
+        return false;
+
+    memcpy(result, pair.value, sizeof(*result));
+    return true;
+}
+
+static const char* getPoolProps(int zfsfd, const char* name, FFstrbuf* buffer)
+{
+    union {
+        FFZfsCmd cmd;
+        uint8_t raw[32 * 1024]; // > sizeof(zfs_cmd_t), which is about 14 KiB
+    } zc = {};
+    ffStrCopy(zc.cmd.name, name, sizeof(zc.cmd.name));
+
+    ffStrbufClear(buffer);
+    ffStrbufEnsureFree(buffer, 16 * 1024);
+    for (int retry = 0; retry < 3; ++retry)
+    {
+        zc.cmd.nvlistDst = (uint64_t) (uintptr_t) buffer->chars;
+        zc.cmd.nvlistDstSize = buffer->allocated;
+        if (ioctl(zfsfd, FF_ZFS_IOC_POOL_GET_PROPS, &zc) == 0)
+        {
+            if (zc.cmd.nvlistDstSize > buffer->allocated) return "ZFS_IOC_POOL_GET_PROPS returned invalid size";
+            buffer->length = (uint32_t) zc.cmd.nvlistDstSize;
+            return NULL;
+        }
+        if (errno != ENOMEM || zc.cmd.nvlistDstSize <= buffer->allocated)
+            return "ioctl(ZFS_IOC_POOL_GET_PROPS) failed";
+        // The kernel stores the required size
+        ffStrbufEnsureFree(buffer, (uint32_t) zc.cmd.nvlistDstSize);
+    }
+    return "ioctl(ZFS_IOC_POOL_GET_PROPS) failed";
+}
+
+static int sortByName(const FFZpoolResult* a, const FFZpoolResult* b)
+{
+    return ffStrbufComp(&a->name, &b->name);
+}
+
+static const char* detectByKstat(FFlist* result)
+{
+    FF_AUTO_CLOSE_DIR DIR* dirp = opendir("/proc/spl/kstat/zfs/");
+    if (!dirp) return "`zfs` kernel module is not loaded";
+
+    FF_AUTO_CLOSE_FD int zfsfd = open("/dev/zfs", O_RDWR | O_CLOEXEC);
+    if (zfsfd < 0) return "open(\"/dev/zfs\") failed";
+
+    FF_STRBUF_AUTO_DESTROY state = ffStrbufCreate();
+    FF_STRBUF_AUTO_DESTROY props = ffStrbufCreate();
+
+    struct dirent* entry;
+    while ((entry = readdir(dirp)) != NULL)
+    {
+        if (entry->d_name[0] == '.' || (entry->d_type != DT_DIR && entry->d_type != DT_UNKNOWN))
+            continue;
+
+        // Only pool directories contain `state`
+        FF_AUTO_CLOSE_FD int dfd = openat(dirfd(dirp), entry->d_name, O_RDONLY | O_CLOEXEC | O_PATH | O_DIRECTORY);
+        if (dfd < 0 || !ffReadFileBufferRelative(dfd, "state", &state))
+            continue;
+        ffStrbufTrimRightSpace(&state);
+
+        const char* error = getPoolProps(zfsfd, entry->d_name, &props);
+        if (error) return error;
+
+        const uint8_t* begin = (const uint8_t*) props.chars;
+        const uint8_t* end = begin + props.length;
+        // nvs_header_t: encoding (native), endian (host)
+        if (props.length < 4 || begin[0] != 0 || begin[1] != (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__))
+            return "ZFS_IOC_POOL_GET_PROPS returned unsupported nvlist encoding";
+        begin += 4;
+
+        uint64_t size = 0, allocated = 0, fragmentation = UINT64_MAX, version = 5000 /* SPA_VERSION_FEATURES */;
+        if (!getPropUint64(begin, end, "size", &size) || !getPropUint64(begin, end, "allocated", &allocated))
+            return "Failed to decode pool properties";
+        getPropUint64(begin, end, "fragmentation", &fragmentation);
+        getPropUint64(begin, end, "version", &version);
+
+        FFZpoolResult* item = ffListAdd(result);
+        ffStrbufInitS(&item->name, entry->d_name);
+        ffStrbufInitMove(&item->state, &state);
+        item->version = version;
+        item->total = size;
+        item->used = allocated;
+        item->fragmentation = fragmentation == UINT64_MAX ? 0.0/0.0 : (double) fragmentation;
+    }
+
+    // libzfs iterates pools sorted by name
+    ffListSort(result, (const void*) sortByName);
+    return NULL;
+}
+
+static void clearResults(FFlist* result)
+{
+    FF_LIST_FOR_EACH(FFZpoolResult, item, *result)
+    {
+        ffStrbufDestroy(&item->name);
+        ffStrbufDestroy(&item->state);
+    }
+    result->length = 0;
+}
+#endif
+
 #ifdef FF_HAVE_LIBZFS
 #include "util/kmod.h"
 
@@ -78,7 +287,7 @@ static int enumZpoolCallback(zpool_handle_t* zpool, void* param)
     return 0;
 }
 
-const char* ffDetectZpool(FFlist* result /* list of FFZpoolResult */)
+static const char* detectByLibzfs(FFlist* result)
 {
     FF_LIBRARY_LOAD(libzfs, "dlopen libzfs" FF_LIBRARY_EXTENSION " failed", "libzfs" FF_LIBRARY_EXTENSION, 4);
     FF_LIBRARY_LOAD_SYMBOL_MESSAGE(libzfs, libzfs_init);
@@ -107,11 +316,21 @@ const char* ffDetectZpool(FFlist* result /* list of FFZpoolResult */)
     return NULL;
 }
 
-#else
+#endif
 
-const char* ffDetectZpool(FF_MAYBE_UNUSED FFlist* result)
+const char* ffDetectZpool(FF_MAYBE_UNUSED FFlist* result /* list of FFZpoolResult */)
 {
+    #ifdef __linux__
+    const char* error = detectByKstat(result);
+    if (error == NULL) return NULL;
+    clearResults(result);
+    #endif
+
+    #ifdef FF_HAVE_LIBZFS
+    return detectByLibzfs(result);
+    #elif defined(__linux__)
+    return error;
+    #else
     return "Fastfetch was compiled without libzfs support";
+    #endif
 }
-
-#endif
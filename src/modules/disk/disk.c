@@ -75,6 +75,8 @@ static void printDisk(FFDiskOptions* options, const FFDisk* disk, uint32_t index
                 ffStrbufAppendC(&str, ' ');
             }
         }
+        else if(disk->type & FF_DISK_VOLUME_TYPE_UNAVAILABLE_BIT)
+            ffStrbufAppendS(&str, "Unavailable ");
         else
             ffStrbufAppendS(&str, "Unknown ");
 
@@ -176,7 +178,7 @@ void ffPrintDisk(FFDiskOptions* options)
         uint32_t index = 0;
         FF_LIST_FOR_EACH(FFDisk, disk, disks)
         {
-            if(__builtin_expect(options->folders.length == 0, 1) && (disk->type & ~options->showTypes))
+            if(__builtin_expect(options->folders.length == 0, 1) && (disk->type & ~options->showTypes & ~FF_DISK_VOLUME_TYPE_UNAVAILABLE_BIT))
                 continue;
 
             printDisk(options, disk, ++index);
@@ -259,6 +261,12 @@ bool ffParseDiskCommandOptions(FFDiskOptions* options, const char* key, const ch
         return true;
     }
 
+    if (ffStrEqualsIgnCase(subKey, "timeout"))
+    {
+        options->timeout = ffOptionParseUInt32(key, value);
+        return true;
+    }
+
     if (ffStrEqualsIgnCase(subKey, "use-available"))
     {
         if (ffOptionParseBoolean(value))
@@ -338,6 +346,12 @@ void ffParseDiskJsonObject(FFDiskOptions* options, yyjson_val* module)
             continue;
         }
 
+        if (ffStrEqualsIgnCase(key, "timeout"))
+        {
+            options->timeout = (uint32_t) yyjson_get_uint(val);
+            continue;
+        }
+
         if (ffStrEqualsIgnCase(key, "useAvailable"))
         {
             if (yyjson_get_bool(val))
@@ -385,6 +399,9 @@ void ffGenerateDiskJsonConfig(FFDiskOptions* options, yyjson_mut_doc* doc, yyjso
     if (defaultOptions.calcType != options->calcType)
         yyjson_mut_obj_add_bool(doc, module, "useAvailable", options->calcType == FF_DISK_CALC_TYPE_AVAILABLE);
 
+    if (defaultOptions.timeout != options->timeout)
+        yyjson_mut_obj_add_uint(doc, module, "timeout", options->timeout);
+
     ffPercentGenerateJsonConfig(doc, module, defaultOptions.percent, options->percent);
 }
 
@@ -440,6 +457,8 @@ void ffGenerateDiskJsonResult(FFDiskOptions* options, yyjson_mut_doc* doc, yyjso
             yyjson_mut_arr_add_str(doc, typeArr, "Read-only");
         if(item->type & FF_DISK_VOLUME_TYPE_UNKNOWN_BIT)
             yyjson_mut_arr_add_str(doc, typeArr, "Unknown");
+        if(item->type & FF_DISK_VOLUME_TYPE_UNAVAILABLE_BIT)
+            yyjson_mut_arr_add_str(doc, typeArr, "Unavailable");
 
         const char* pstr = ffTimeToFullStr(item->createTime);
         if (*pstr)
@@ -498,6 +517,7 @@ void ffInitDiskOptions(FFDiskOptions* options)
     ffStrbufInit(&options->folders);
     options->showTypes = FF_DISK_VOLUME_TYPE_REGULAR_BIT | FF_DISK_VOLUME_TYPE_EXTERNAL_BIT | FF_DISK_VOLUME_TYPE_READONLY_BIT;
     options->calcType = FF_DISK_CALC_TYPE_FREE;
+    options->timeout = 1000;
     options->percent = (FFPercentageModuleConfig) { 50, 80, 0 };
 }
 
@@ -14,6 +14,7 @@ typedef enum __attribute__((__packed__)) FFDiskVolumeType
     FF_DISK_VOLUME_TYPE_SUBVOLUME_BIT = 1 << 3,
     FF_DISK_VOLUME_TYPE_UNKNOWN_BIT = 1 << 4,
     FF_DISK_VOLUME_TYPE_READONLY_BIT = 1 << 5,
+    FF_DISK_VOLUME_TYPE_UNAVAILABLE_BIT = 1 << 6, // Not responding in time
     FF_DISK_VOLUME_TYPE_FORCE_UNSIGNED = UINT8_MAX,
 } FFDiskVolumeType;
 
@@ -31,5 +32,6 @@ typedef struct FFDiskOptions
     FFstrbuf folders;
     FFDiskVolumeType showTypes;
     FFDiskCalcType calcType;
+    uint32_t timeout;
     FFPercentageModuleConfig percent;
 } FFDiskOptions;
@@ -72,7 +72,7 @@ void ffPrintDiskIO(FFDiskIOOptions* options)
             ffParseSize(dev->bytesRead, &buffer);
             if (!options->detectTotal) ffStrbufAppendS(&buffer, "/s");
             ffParseSize(dev->bytesWritten, &buffer2);
-            if (!options->detectTotal) ffStrbufAppendS(&buffer, "/s");
+            if (!options->detectTotal) ffStrbufAppendS(&buffer2, "/s");
 
             FF_PRINT_FORMAT_CHECKED(key.chars, 0, &options->moduleArgs, FF_PRINT_TYPE_NO_CUSTOM_KEY, ((FFformatarg[]){
                 FF_FORMAT_ARG(buffer, "size-read"),
@@ -83,6 +83,14 @@ void ffPrintDiskIO(FFDiskIOOptions* options)
                 FF_FORMAT_ARG(dev->bytesWritten, "bytes-written"),
                 FF_FORMAT_ARG(dev->readCount, "read-count"),
                 FF_FORMAT_ARG(dev->writeCount, "write-count"),
+                FF_FORMAT_ARG(dev->discardCount, "discard-count"),
+                FF_FORMAT_ARG(dev->flushCount, "flush-count"),
+                FF_FORMAT_ARG(dev->readAwait, "read-await"),
+                FF_FORMAT_ARG(dev->writeAwait, "write-await"),
+                FF_FORMAT_ARG(dev->utilization, "utilization"),
+                FF_FORMAT_ARG(dev->utilizationPeak, "utilization-peak"),
+                FF_FORMAT_ARG(dev->queueDepth, "queue-depth"),
+                FF_FORMAT_ARG(dev->inFlight, "in-flight"),
             }));
         }
         ++index;
@@ -120,6 +128,18 @@ bool ffParseDiskIOCommandOptions(FFDiskIOOptions* options, const char* key, cons
         return true;
     }
 
+    if (ffStrEqualsIgnCase(subKey, "sample-count"))
+    {
+        options->sampleCount = ffOptionParseUInt32(key, value);
+        return true;
+    }
+
+    if (ffStrEqualsIgnCase(subKey, "snapshot-max-age"))
+    {
+        options->snapshotMaxAge = ffOptionParseUInt32(key, value);
+        return true;
+    }
+
     return false;
 }
 
@@ -154,6 +174,18 @@ void ffParseDiskIOJsonObject(FFDiskIOOptions* options, yyjson_val* module)
             continue;
         }
 
+        if (ffStrEqualsIgnCase(key, "sampleCount"))
+        {
+            options->sampleCount = (uint32_t) yyjson_get_uint(val);
+            continue;
+        }
+
+        if (ffStrEqualsIgnCase(key, "snapshotMaxAge"))
+        {
+            options->snapshotMaxAge = (uint32_t) yyjson_get_uint(val);
+            continue;
+        }
+
         ffPrintError(FF_DISKIO_MODULE_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT, "Unknown JSON key %s", key);
     }
 }
@@ -170,6 +202,15 @@ void ffGenerateDiskIOJsonConfig(FFDiskIOOptions* options, yyjson_mut_doc* doc, y
 
     if (defaultOptions.detectTotal != options->detectTotal)
         yyjson_mut_obj_add_bool(doc, module, "detectTotal", options->detectTotal);
+
+    if (defaultOptions.waitTime != options->waitTime)
+        yyjson_mut_obj_add_uint(doc, module, "waitTime", options->waitTime);
+
+    if (defaultOptions.sampleCount != options->sampleCount)
+        yyjson_mut_obj_add_uint(doc, module, "sampleCount", options->sampleCount);
+
+    if (defaultOptions.snapshotMaxAge != options->snapshotMaxAge)
+        yyjson_mut_obj_add_uint(doc, module, "snapshotMaxAge", options->snapshotMaxAge);
 }
 
 void ffGenerateDiskIOJsonResult(FFDiskIOOptions* options, yyjson_mut_doc* doc, yyjson_mut_val* module)
@@ -193,6 +234,28 @@ void ffGenerateDiskIOJsonResult(FFDiskIOOptions* options, yyjson_mut_doc* doc, y
         yyjson_mut_obj_add_uint(doc, obj, "bytesWritten", dev->bytesWritten);
         yyjson_mut_obj_add_uint(doc, obj, "readCount", dev->readCount);
         yyjson_mut_obj_add_uint(doc, obj, "writeCount", dev->writeCount);
+
+        if (dev->hasExtendedStats)
+        {
+            yyjson_mut_obj_add_uint(doc, obj, "bytesDiscarded", dev->bytesDiscarded);
+            yyjson_mut_obj_add_uint(doc, obj, "discardCount", dev->discardCount);
+            yyjson_mut_obj_add_uint(doc, obj, "flushCount", dev->flushCount);
+            yyjson_mut_obj_add_uint(doc, obj, "readTime", dev->readTime);
+            yyjson_mut_obj_add_uint(doc, obj, "writeTime", dev->writeTime);
+            yyjson_mut_obj_add_uint(doc, obj, "discardTime", dev->discardTime);
+            yyjson_mut_obj_add_uint(doc, obj, "flushTime", dev->flushTime);
+            yyjson_mut_obj_add_uint(doc, obj, "ioTime", dev->ioTime);
+            yyjson_mut_obj_add_uint(doc, obj, "queueTime", dev->queueTime);
+            yyjson_mut_obj_add_uint(doc, obj, "inFlight", dev->inFlight);
+            if (!options->detectTotal)
+            {
+                yyjson_mut_obj_add_real(doc, obj, "readAwait", dev->readAwait);
+                yyjson_mut_obj_add_real(doc, obj, "writeAwait", dev->writeAwait);
+                yyjson_mut_obj_add_real(doc, obj, "utilization", dev->utilization);
+                yyjson_mut_obj_add_real(doc, obj, "utilizationPeak", dev->utilizationPeak);
+                yyjson_mut_obj_add_real(doc, obj, "queueDepth", dev->queueDepth);
+            }
+        }
     }
 
     FF_LIST_FOR_EACH(FFDiskIOResult, dev, result)
@@ -219,6 +282,14 @@ static FFModuleBaseInfo ffModuleInfo = {
         {"Size of data written [per second] (in bytes)", "bytes-written"},
         {"Number of reads", "read-count"},
         {"Number of writes", "write-count"},
+        {"Number of discards", "discard-count"},
+        {"Number of flushes", "flush-count"},
+        {"Average time of read requests in ms, including queueing", "read-await"},
+        {"Average time of write requests in ms, including queueing", "write-await"},
+        {"Percentage of time the device was busy", "utilization"},
+        {"Highest utilization among the sampling intervals", "utilization-peak"},
+        {"Average number of requests in flight", "queue-depth"},
+        {"Number of requests in flight", "in-flight"},
     }))
 };
 
@@ -230,6 +301,8 @@ void ffInitDiskIOOptions(FFDiskIOOptions* options)
     ffStrbufInit(&options->namePrefix);
     options->detectTotal = false;
     options->waitTime = 1000;
+    options->sampleCount = 1;
+    options->snapshotMaxAge = 0;
 }
 
 void ffDestroyDiskIOOptions(FFDiskIOOptions* options)
@@ -11,5 +11,7 @@ typedef struct FFDiskIOOptions
 
     FFstrbuf namePrefix;
     uint32_t waitTime;
+    uint32_t sampleCount;
+    uint32_t snapshotMaxAge;
     bool detectTotal;
 } FFDiskIOOptions;
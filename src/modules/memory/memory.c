@@ -6,6 +6,31 @@
 #include "modules/memory/memory.h"
 #include "util/stringUtils.h"
 
+static void appendDetails(const FFMemoryResult* storage, FFstrbuf* str)
+{
+    ffStrbufAppendS(str, " (Dirty: ");
+    ffParseSize(storage->bytesDirty, str);
+    ffStrbufAppendS(str, ", Writeback: ");
+    ffParseSize(storage->bytesWriteback, str);
+    ffStrbufAppendS(str, ", Slab: ");
+    ffParseSize(storage->bytesSlab, str);
+    if (storage->bytesZswapped > 0)
+    {
+        ffStrbufAppendS(str, ", Zswap: ");
+        ffParseSize(storage->bytesZswap, str);
+        ffStrbufAppendS(str, " / ");
+        ffParseSize(storage->bytesZswapped, str);
+    }
+    if (storage->bytesHugePagesTotal > 0)
+    {
+        ffStrbufAppendS(str, ", HugePages: ");
+        ffParseSize(storage->bytesHugePagesUsed, str);
+        ffStrbufAppendS(str, " / ");
+        ffParseSize(storage->bytesHugePagesTotal, str);
+    }
+    ffStrbufAppendC(str, ')');
+}
+
 void ffPrintMemory(FFMemoryOptions* options)
 {
     FFMemoryResult storage = {};
@@ -50,6 +75,10 @@ void ffPrintMemory(FFMemoryOptions* options)
                 ffPercentAppendNum(&str, percentage, options->percent, str.length > 0, &options->moduleArgs);
 
             ffStrbufTrimRight(&str, ' ');
+
+            if (options->details && storage.detailsAvailable)
+                appendDetails(&storage, &str);
+
             ffStrbufPutTo(&str, stdout);
         }
     }
@@ -62,11 +91,33 @@ void ffPrintMemory(FFMemoryOptions* options)
         if (percentType & FF_PERCENTAGE_TYPE_BAR_BIT)
             ffPercentAppendBar(&percentageBar, percentage, options->percent, &options->moduleArgs);
 
+        FF_STRBUF_AUTO_DESTROY dirty = ffStrbufCreate();
+        ffParseSize(storage.bytesDirty, &dirty);
+        FF_STRBUF_AUTO_DESTROY writeback = ffStrbufCreate();
+        ffParseSize(storage.bytesWriteback, &writeback);
+        FF_STRBUF_AUTO_DESTROY slab = ffStrbufCreate();
+        ffParseSize(storage.bytesSlab, &slab);
+        FF_STRBUF_AUTO_DESTROY zswap = ffStrbufCreate();
+        ffParseSize(storage.bytesZswap, &zswap);
+        FF_STRBUF_AUTO_DESTROY zswapped = ffStrbufCreate();
+        ffParseSize(storage.bytesZswapped, &zswapped);
+        FF_STRBUF_AUTO_DESTROY hugePagesUsed = ffStrbufCreate();
+        ffParseSize(storage.bytesHugePagesUsed, &hugePagesUsed);
+        FF_STRBUF_AUTO_DESTROY hugePagesTotal = ffStrbufCreate();
+        ffParseSize(storage.bytesHugePagesTotal, &hugePagesTotal);
+
         FF_PRINT_FORMAT_CHECKED(FF_MEMORY_MODULE_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT, ((FFformatarg[]){
             FF_FORMAT_ARG(usedPretty, "used"),
             FF_FORMAT_ARG(totalPretty, "total"),
             FF_FORMAT_ARG(percentageNum, "percentage"),
             FF_FORMAT_ARG(percentageBar, "percentage-bar"),
+            FF_FORMAT_ARG(dirty, "dirty"),
+            FF_FORMAT_ARG(writeback, "writeback"),
+            FF_FORMAT_ARG(slab, "slab"),
+            FF_FORMAT_ARG(zswap, "zswap"),
+            FF_FORMAT_ARG(zswapped, "zswapped"),
+            FF_FORMAT_ARG(hugePagesUsed, "hugepages-used"),
+            FF_FORMAT_ARG(hugePagesTotal, "hugepages-total"),
         }));
     }
 }
@@ -81,6 +132,12 @@ bool ffParseMemoryCommandOptions(FFMemoryOptions* options, const char* key, cons
     if (ffPercentParseCommandOptions(key, subKey, value, &options->percent))
         return true;
 
+    if (ffStrEqualsIgnCase(subKey, "details"))
+    {
+        options->details = ffOptionParseBoolean(value);
+        return true;
+    }
+
     return false;
 }
 
@@ -100,6 +157,12 @@ void ffParseMemoryJsonObject(FFMemoryOptions* options, yyjson_val* module)
         if (ffPercentParseJsonObject(key, val, &options->percent))
             continue;
 
+        if (ffStrEqualsIgnCase(key, "details"))
+        {
+            options->details = yyjson_get_bool(val);
+            continue;
+        }
+
         ffPrintError(FF_MEMORY_MODULE_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT, "Unknown JSON key %s", key);
     }
 }
@@ -112,11 +175,14 @@ void ffGenerateMemoryJsonConfig(FFMemoryOptions* options, yyjson_mut_doc* doc, y
     ffJsonConfigGenerateModuleArgsConfig(doc, module, &defaultOptions.moduleArgs, &options->moduleArgs);
 
     ffPercentGenerateJsonConfig(doc, module, defaultOptions.percent, options->percent);
+
+    if (options->details != defaultOptions.details)
+        yyjson_mut_obj_add_bool(doc, module, "details", options->details);
 }
 
-void ffGenerateMemoryJsonResult(FF_MAYBE_UNUSED FFMemoryOptions* options, yyjson_mut_doc* doc, yyjson_mut_val* module)
+void ffGenerateMemoryJsonResult(FFMemoryOptions* options, yyjson_mut_doc* doc, yyjson_mut_val* module)
 {
-    FFMemoryResult storage;
+    FFMemoryResult storage = {};
     const char* error = ffDetectMemory(&storage);
 
     if(error)
@@ -128,6 +194,18 @@ void ffGenerateMemoryJsonResult(FF_MAYBE_UNUSED FFMemoryOptions* options, yyjson
     yyjson_mut_val* obj = yyjson_mut_obj_add_obj(doc, module, "result");
     yyjson_mut_obj_add_uint(doc, obj, "total", storage.bytesTotal);
     yyjson_mut_obj_add_uint(doc, obj, "used", storage.bytesUsed);
+
+    if (options->details && storage.detailsAvailable)
+    {
+        yyjson_mut_val* details = yyjson_mut_obj_add_obj(doc, obj, "details");
+        yyjson_mut_obj_add_uint(doc, details, "dirty", storage.bytesDirty);
+        yyjson_mut_obj_add_uint(doc, details, "writeback", storage.bytesWriteback);
+        yyjson_mut_obj_add_uint(doc, details, "slab", storage.bytesSlab);
+        yyjson_mut_obj_add_uint(doc, details, "zswap", storage.bytesZswap);
+        yyjson_mut_obj_add_uint(doc, details, "zswapped", storage.bytesZswapped);
+        yyjson_mut_obj_add_uint(doc, details, "hugePagesUsed", storage.bytesHugePagesUsed);
+        yyjson_mut_obj_add_uint(doc, details, "hugePagesTotal", storage.bytesHugePagesTotal);
+    }
 }
 
 static FFModuleBaseInfo ffModuleInfo = {
@@ -143,6 +221,13 @@ static FFModuleBaseInfo ffModuleInfo = {
         {"Total size", "total"},
         {"Percentage used (num)", "percentage"},
         {"Percentage used (bar)", "percentage-bar"},
+        {"Dirty size", "dirty"},
+        {"Writeback size", "writeback"},
+        {"Slab size", "slab"},
+        {"Zswap size (compressed)", "zswap"},
+        {"Zswapped size (uncompressed)", "zswapped"},
+        {"Huge pages used size", "hugepages-used"},
+        {"Huge pages total size", "hugepages-total"},
     }))
 };
 
@@ -151,6 +236,7 @@ void ffInitMemoryOptions(FFMemoryOptions* options)
     options->moduleInfo = ffModuleInfo;
     ffOptionInitModuleArg(&options->moduleArgs, "");
     options->percent = (FFPercentageModuleConfig) { 50, 80, 0 };
+    options->details = false;
 }
 
 void ffDestroyMemoryOptions(FFMemoryOptions* options)
@@ -11,4 +11,5 @@ typedef struct FFMemoryOptions
     FFModuleArgs moduleArgs;
 
     FFPercentageModuleConfig percent;
+    bool details;
 } FFMemoryOptions;
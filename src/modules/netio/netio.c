@@ -134,6 +134,12 @@ bool ffParseNetIOCommandOptions(FFNetIOOptions* options, const char* key, const
         return true;
     }
 
+    if (ffStrEqualsIgnCase(subKey, "snapshot-max-age"))
+    {
+        options->snapshotMaxAge = ffOptionParseUInt32(key, value);
+        return true;
+    }
+
     return false;
 }
 
@@ -174,6 +180,12 @@ void ffParseNetIOJsonObject(FFNetIOOptions* options, yyjson_val* module)
             continue;
         }
 
+        if (ffStrEqualsIgnCase(key, "snapshotMaxAge"))
+        {
+            options->snapshotMaxAge = (uint32_t) yyjson_get_uint(val);
+            continue;
+        }
+
         ffPrintError(FF_NETIO_MODULE_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT, "Unknown JSON key %s", key);
     }
 }
@@ -193,6 +205,12 @@ void ffGenerateNetIOJsonConfig(FFNetIOOptions* options, yyjson_mut_doc* doc, yyj
 
     if (options->detectTotal != defaultOptions.detectTotal)
         yyjson_mut_obj_add_bool(doc, module, "detectTotal", options->detectTotal);
+
+    if (options->waitTime != defaultOptions.waitTime)
+        yyjson_mut_obj_add_uint(doc, module, "waitTime", options->waitTime);
+
+    if (options->snapshotMaxAge != defaultOptions.snapshotMaxAge)
+        yyjson_mut_obj_add_uint(doc, module, "snapshotMaxAge", options->snapshotMaxAge);
 }
 
 void ffGenerateNetIOJsonResult(FFNetIOOptions* options, yyjson_mut_doc* doc, yyjson_mut_val* module)
@@ -267,6 +285,7 @@ void ffInitNetIOOptions(FFNetIOOptions* options)
     ;
     options->detectTotal = false;
     options->waitTime = 1000;
+    options->snapshotMaxAge = 0;
 }
 
 void ffDestroyNetIOOptions(FFNetIOOptions* options)
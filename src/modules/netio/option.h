@@ -11,6 +11,7 @@ typedef struct FFNetIOOptions
 
     FFstrbuf namePrefix;
     uint32_t waitTime;
+    uint32_t snapshotMaxAge;
     bool defaultRouteOnly;
     bool detectTotal;
 } FFNetIOOptions;
@@ -12,4 +12,6 @@ typedef struct FFPhysicalDiskOptions
     FFstrbuf namePrefix;
     bool temp;
     FFColorRangeConfig tempConfig;
+    bool health;
+    uint32_t healthTtl;
 } FFPhysicalDiskOptions;
@@ -6,6 +6,8 @@
 #include "modules/physicaldisk/physicaldisk.h"
 #include "util/stringUtils.h"
 
+#include <inttypes.h>
+
 #define FF_PHYSICALDISK_DISPLAY_NAME "Physical Disk"
 
 static int sortDevices(const FFPhysicalDiskResult* left, const FFPhysicalDiskResult* right)
@@ -31,6 +33,16 @@ static void formatKey(const FFPhysicalDiskOptions* options, FFPhysicalDiskResult
     }
 }
 
+static void appendHealthValue(FFstrbuf* buffer, uint64_t value, bool isSize)
+{
+    if (value == FF_PHYSICALDISK_HEALTH_UNSET)
+        return;
+    if (isSize)
+        ffParseSize(value, buffer);
+    else
+        ffStrbufAppendF(buffer, "%" PRIu64, value);
+}
+
 void ffPrintPhysicalDisk(FFPhysicalDiskOptions* options)
 {
     FF_LIST_AUTO_DESTROY result = ffListCreate(sizeof(FFPhysicalDiskResult));
@@ -99,6 +111,15 @@ void ffPrintPhysicalDisk(FFPhysicalDiskOptions* options)
 
                 ffTempsAppendNum(dev->temperature, &buffer, options->tempConfig, &options->moduleArgs);
             }
+
+            if (dev->health.percentageUsed != FF_PHYSICALDISK_HEALTH_UNSET)
+            {
+                if(buffer.length > 0)
+                    ffStrbufAppendS(&buffer, " - ");
+                ffStrbufAppendF(&buffer, "%u%% used", (unsigned) dev->health.percentageUsed);
+            }
+            if (dev->health.mediaErrors != FF_PHYSICALDISK_HEALTH_UNSET && dev->health.mediaErrors > 0)
+                ffStrbufAppendF(&buffer, " (%" PRIu64 " media errors)", dev->health.mediaErrors);
             ffStrbufPutTo(&buffer, stdout);
         }
         else
@@ -107,6 +128,19 @@ void ffPrintPhysicalDisk(FFPhysicalDiskOptions* options)
             ffTempsAppendNum(dev->temperature, &tempStr, options->tempConfig, &options->moduleArgs);
             if (dev->type & FF_PHYSICALDISK_TYPE_READWRITE)
                 readOnlyType = "Read-write";
+
+            FF_STRBUF_AUTO_DESTROY percentageUsed = ffStrbufCreate();
+            appendHealthValue(&percentageUsed, dev->health.percentageUsed, false);
+            FF_STRBUF_AUTO_DESTROY mediaErrors = ffStrbufCreate();
+            appendHealthValue(&mediaErrors, dev->health.mediaErrors, false);
+            FF_STRBUF_AUTO_DESTROY powerOnHours = ffStrbufCreate();
+            appendHealthValue(&powerOnHours, dev->health.powerOnHours, false);
+            FF_STRBUF_AUTO_DESTROY unsafeShutdowns = ffStrbufCreate();
+            appendHealthValue(&unsafeShutdowns, dev->health.unsafeShutdowns, false);
+            FF_STRBUF_AUTO_DESTROY sizeRead = ffStrbufCreate();
+            appendHealthValue(&sizeRead, dev->health.bytesRead, true);
+            FF_STRBUF_AUTO_DESTROY sizeWritten = ffStrbufCreate();
+            appendHealthValue(&sizeWritten, dev->health.bytesWritten, true);
             FF_PRINT_FORMAT_CHECKED(key.chars, 0, &options->moduleArgs, FF_PRINT_TYPE_NO_CUSTOM_KEY, ((FFformatarg[]){
                 FF_FORMAT_ARG(buffer, "size"),
                 FF_FORMAT_ARG(dev->name, "name"),
@@ -118,6 +152,12 @@ void ffPrintPhysicalDisk(FFPhysicalDiskOptions* options)
                 FF_FORMAT_ARG(readOnlyType, "readonly-type"),
                 FF_FORMAT_ARG(dev->revision, "revision"),
                 FF_FORMAT_ARG(tempStr, "temperature"),
+                FF_FORMAT_ARG(percentageUsed, "percentage-used"),
+                FF_FORMAT_ARG(mediaErrors, "media-errors"),
+                FF_FORMAT_ARG(powerOnHours, "power-on-hours"),
+                FF_FORMAT_ARG(unsafeShutdowns, "unsafe-shutdowns"),
+                FF_FORMAT_ARG(sizeRead, "size-read"),
+                FF_FORMAT_ARG(sizeWritten, "size-written"),
             }));
         }
         ++index;
@@ -149,6 +189,18 @@ bool ffParsePhysicalDiskCommandOptions(FFPhysicalDiskOptions* options, const cha
     if (ffTempsParseCommandOptions(key, subKey, value, &options->temp, &options->tempConfig))
         return true;
 
+    if (ffStrEqualsIgnCase(subKey, "health"))
+    {
+        options->health = ffOptionParseBoolean(value);
+        return true;
+    }
+
+    if (ffStrEqualsIgnCase(subKey, "health-ttl"))
+    {
+        options->healthTtl = ffOptionParseUInt32(key, value);
+        return true;
+    }
+
     return false;
 }
 
@@ -174,6 +226,18 @@ void ffParsePhysicalDiskJsonObject(FFPhysicalDiskOptions* options, yyjson_val* m
         if (ffTempsParseJsonObject(key, val, &options->temp, &options->tempConfig))
             continue;
 
+        if (ffStrEqualsIgnCase(key, "health"))
+        {
+            options->health = yyjson_get_bool(val);
+            continue;
+        }
+
+        if (ffStrEqualsIgnCase(key, "healthTtl"))
+        {
+            options->healthTtl = (uint32_t) yyjson_get_uint(val);
+            continue;
+        }
+
         ffPrintError(FF_PHYSICALDISK_MODULE_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT, "Unknown JSON key %s", key);
     }
 }
@@ -189,6 +253,20 @@ void ffGeneratePhysicalDiskJsonConfig(FFPhysicalDiskOptions* options, yyjson_mut
         yyjson_mut_obj_add_strbuf(doc, module, "namePrefix", &options->namePrefix);
 
     ffTempsGenerateJsonConfig(doc, module, defaultOptions.temp, defaultOptions.tempConfig, options->temp, options->tempConfig);
+
+    if (options->health != defaultOptions.health)
+        yyjson_mut_obj_add_bool(doc, module, "health", options->health);
+
+    if (options->healthTtl != defaultOptions.healthTtl)
+        yyjson_mut_obj_add_uint(doc, module, "healthTtl", options->healthTtl);
+}
+
+static void addHealthValue(yyjson_mut_doc* doc, yyjson_mut_val* obj, const char* key, uint64_t value)
+{
+    if (value == FF_PHYSICALDISK_HEALTH_UNSET)
+        yyjson_mut_obj_add_null(doc, obj, key);
+    else
+        yyjson_mut_obj_add_uint(doc, obj, key, value);
 }
 
 void ffGeneratePhysicalDiskJsonResult(FFPhysicalDiskOptions* options, yyjson_mut_doc* doc, yyjson_mut_val* module)
@@ -237,6 +315,17 @@ void ffGeneratePhysicalDiskJsonResult(FFPhysicalDiskOptions* options, yyjson_mut
         yyjson_mut_obj_add_strbuf(doc, obj, "revision", &dev->revision);
 
         yyjson_mut_obj_add_real(doc, obj, "temperature", dev->temperature);
+
+        if (options->health)
+        {
+            yyjson_mut_val* health = yyjson_mut_obj_add_obj(doc, obj, "health");
+            addHealthValue(doc, health, "percentageUsed", dev->health.percentageUsed);
+            addHealthValue(doc, health, "mediaErrors", dev->health.mediaErrors);
+            addHealthValue(doc, health, "powerOnHours", dev->health.powerOnHours);
+            addHealthValue(doc, health, "unsafeShutdowns", dev->health.unsafeShutdowns);
+            addHealthValue(doc, health, "bytesRead", dev->health.bytesRead);
+            addHealthValue(doc, health, "bytesWritten", dev->health.bytesWritten);
+        }
     }
 
     FF_LIST_FOR_EACH(FFPhysicalDiskResult, dev, result)
@@ -268,6 +357,12 @@ static FFModuleBaseInfo ffModuleInfo = {
         {"Device kind (Read-only or Read-write)", "readonly-type"},
         {"Product revision", "revision"},
         {"Device temperature (formatted)", "temperature"},
+        {"Estimated percentage of life used (health)", "percentage-used"},
+        {"Number of media errors (health)", "media-errors"},
+        {"Power-on hours (health)", "power-on-hours"},
+        {"Number of unsafe shutdowns (health)", "unsafe-shutdowns"},
+        {"Size of data read (formatted, health)", "size-read"},
+        {"Size of data written (formatted, health)", "size-written"},
     }))
 };
 
@@ -279,6 +374,8 @@ void ffInitPhysicalDiskOptions(FFPhysicalDiskOptions* options)
     ffStrbufInit(&options->namePrefix);
     options->temp = false;
     options->tempConfig = (FFColorRangeConfig) { 50, 70 };
+    options->health = false;
+    options->healthTtl = 600;
 }
 
 void ffDestroyPhysicalDiskOptions(FFPhysicalDiskOptions* options)
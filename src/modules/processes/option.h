@@ -8,4 +8,6 @@ typedef struct FFProcessesOptions
 {
     FFModuleBaseInfo moduleInfo;
     FFModuleArgs moduleArgs;
+
+    bool fast;
 } FFProcessesOptions;
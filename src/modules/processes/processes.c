@@ -6,8 +6,10 @@
 
 void ffPrintProcesses(FFProcessesOptions* options)
 {
-    uint32_t numProcesses = 0;
-    const char* error = ffDetectProcesses(&numProcesses);
+    FFProcessesResult result = {};
+    const char* error = ffDetectProcesses(options,
+        ffFormatStringUsesArg(&options->moduleArgs.outputFormat, 4, "running") || ffFormatStringUsesArg(&options->moduleArgs.outputFormat, 5, "blocked"),
+        &result);
 
     if(error)
     {
@@ -15,16 +17,26 @@ void ffPrintProcesses(FFProcessesOptions* options)
         return;
     }
 
+    // Processes are not counted in fast mode
+    uint32_t count = result.processes ? result.processes : result.threads;
+
     if(options->moduleArgs.outputFormat.length == 0)
     {
         ffPrintLogoAndKey(FF_PROCESSES_MODULE_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT);
 
-        printf("%u\n", numProcesses);
+        if (result.processes)
+            printf("%u\n", count);
+        else
+            printf("%u (tasks)\n", count);
     }
     else
     {
         FF_PRINT_FORMAT_CHECKED(FF_PROCESSES_MODULE_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT, ((FFformatarg[]){
-            FF_FORMAT_ARG(numProcesses, "result")
+            FF_FORMAT_ARG(count, "result"),
+            FF_FORMAT_ARG(result.processes, "processes"),
+            FF_FORMAT_ARG(result.threads, "threads"),
+            FF_FORMAT_ARG(result.running, "running"),
+            FF_FORMAT_ARG(result.blocked, "blocked"),
         }));
     }
 }
@@ -36,6 +48,12 @@ bool ffParseProcessesCommandOptions(FFProcessesOptions* options, const char* key
     if (ffOptionParseModuleArgs(key, subKey, value, &options->moduleArgs))
         return true;
 
+    if (ffStrEqualsIgnCase(subKey, "fast"))
+    {
+        options->fast = ffOptionParseBoolean(value);
+        return true;
+    }
+
     return false;
 }
 
@@ -52,6 +70,12 @@ void ffParseProcessesJsonObject(FFProcessesOptions* options, yyjson_val* module)
         if (ffJsonConfigParseModuleArgs(key, val, &options->moduleArgs))
             continue;
 
+        if (ffStrEqualsIgnCase(key, "fast"))
+        {
+            options->fast = yyjson_get_bool(val);
+            continue;
+        }
+
         ffPrintError(FF_PROCESSES_MODULE_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT, "Unknown JSON key %s", key);
     }
 }
@@ -62,12 +86,15 @@ void ffGenerateProcessesJsonConfig(FFProcessesOptions* options, yyjson_mut_doc*
     ffInitProcessesOptions(&defaultOptions);
 
     ffJsonConfigGenerateModuleArgsConfig(doc, module, &defaultOptions.moduleArgs, &options->moduleArgs);
+
+    if (options->fast != defaultOptions.fast)
+        yyjson_mut_obj_add_bool(doc, module, "fast", options->fast);
 }
 
-void ffGenerateProcessesJsonResult(FF_MAYBE_UNUSED FFProcessesOptions* options, yyjson_mut_doc* doc, yyjson_mut_val* module)
+void ffGenerateProcessesJsonResult(FFProcessesOptions* options, yyjson_mut_doc* doc, yyjson_mut_val* module)
 {
-    uint32_t result;
-    const char* error = ffDetectProcesses(&result);
+    FFProcessesResult result = {};
+    const char* error = ffDetectProcesses(options, true, &result);
 
     if(error)
     {
@@ -75,7 +102,12 @@ void ffGenerateProcessesJsonResult(FF_MAYBE_UNUSED FFProcessesOptions* options,
         return;
     }
 
-    yyjson_mut_obj_add_uint(doc, module, "result", result);
+    yyjson_mut_val* obj = yyjson_mut_obj_add_obj(doc, module, "result");
+    yyjson_mut_obj_add_uint(doc, obj, "count", result.processes ? result.processes : result.threads);
+    yyjson_mut_obj_add_uint(doc, obj, "processes", result.processes);
+    yyjson_mut_obj_add_uint(doc, obj, "threads", result.threads);
+    yyjson_mut_obj_add_uint(doc, obj, "running", result.running);
+    yyjson_mut_obj_add_uint(doc, obj, "blocked", result.blocked);
 }
 
 static FFModuleBaseInfo ffModuleInfo = {
@@ -87,7 +119,11 @@ static FFModuleBaseInfo ffModuleInfo = {
     .generateJsonResult = (void*) ffGenerateProcessesJsonResult,
     .generateJsonConfig = (void*) ffGenerateProcessesJsonConfig,
     .formatArgs = FF_FORMAT_ARG_LIST(((FFModuleFormatArg[]) {
-        {"Process count", "result"}
+        {"Process count (task count in fast mode)", "result"},
+        {"Process count (0 in fast mode)", "processes"},
+        {"Thread count (all tasks, including kernel threads)", "threads"},
+        {"Runnable task count", "running"},
+        {"Task count blocked on I/O", "blocked"},
     }))
 };
 
@@ -95,6 +131,7 @@ void ffInitProcessesOptions(FFProcessesOptions* options)
 {
     options->moduleInfo = ffModuleInfo;
     ffOptionInitModuleArg(&options->moduleArgs, "");
+    options->fast = false;
 }
 
 void ffDestroyProcessesOptions(FFProcessesOptions* options)
@@ -11,5 +11,6 @@ typedef struct FFPublicIpOptions
 
     FFstrbuf url;
     uint32_t timeout;
+    uint32_t ttl; // seconds to cache the response, 0 to disable caching
     bool ipv6;
 } FFPublicIpOptions;
@@ -58,6 +58,12 @@ bool ffParsePublicIpCommandOptions(FFPublicIpOptions* options, const char* key,
         return true;
     }
 
+    if (ffStrEqualsIgnCase(subKey, "ttl"))
+    {
+        options->ttl = ffOptionParseUInt32(key, value);
+        return true;
+    }
+
     if (ffStrEqualsIgnCase(subKey, "ipv6"))
     {
         options->ipv6 = ffOptionParseBoolean(value);
@@ -92,6 +98,12 @@ void ffParsePublicIpJsonObject(FFPublicIpOptions* options, yyjson_val* module)
             continue;
         }
 
+        if (ffStrEqualsIgnCase(key, "ttl"))
+        {
+            options->ttl = (uint32_t) yyjson_get_uint(val);
+            continue;
+        }
+
         if (ffStrEqualsIgnCase(key, "ipv6"))
         {
             options->ipv6 = yyjson_get_bool(val);
@@ -115,6 +127,9 @@ void ffGeneratePublicIpJsonConfig(FFPublicIpOptions* options, yyjson_mut_doc* do
     if (defaultOptions.timeout != options->timeout)
         yyjson_mut_obj_add_uint(doc, module, "timeout", options->timeout);
 
+    if (defaultOptions.ttl != options->ttl)
+        yyjson_mut_obj_add_uint(doc, module, "ttl", options->ttl);
+
     if (defaultOptions.ipv6 != options->ipv6)
         yyjson_mut_obj_add_bool(doc, module, "ipv6", options->ipv6);
 }
@@ -161,6 +176,7 @@ void ffInitPublicIpOptions(FFPublicIpOptions* options)
 
     ffStrbufInit(&options->url);
     options->timeout = 0;
+    options->ttl = 0;
     options->ipv6 = false;
 }
 
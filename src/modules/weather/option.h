@@ -12,4 +12,5 @@ typedef struct FFWeatherOptions
     FFstrbuf location;
     FFstrbuf outputFormat;
     uint32_t timeout;
+    uint32_t ttl; // seconds to cache the response, 0 to disable caching
 } FFWeatherOptions;
@@ -54,6 +54,12 @@ bool ffParseWeatherCommandOptions(FFWeatherOptions* options, const char* key, co
         return true;
     }
 
+    if (ffStrEqualsIgnCase(subKey, "ttl"))
+    {
+        options->ttl = ffOptionParseUInt32(key, value);
+        return true;
+    }
+
     return false;
 }
 
@@ -88,6 +94,12 @@ void ffParseWeatherJsonObject(FFWeatherOptions* options, yyjson_val* module)
             continue;
         }
 
+        if (ffStrEqualsIgnCase(key, "ttl"))
+        {
+            options->ttl = (uint32_t) yyjson_get_uint(val);
+            continue;
+        }
+
         ffPrintError(FF_WEATHER_MODULE_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT, "Unknown JSON key %s", key);
     }
 }
@@ -107,6 +119,9 @@ void ffGenerateWeatherJsonConfig(FFWeatherOptions* options, yyjson_mut_doc* doc,
 
     if (options->timeout != defaultOptions.timeout)
         yyjson_mut_obj_add_uint(doc, module, "timeout", options->timeout);
+
+    if (options->ttl != defaultOptions.ttl)
+        yyjson_mut_obj_add_uint(doc, module, "ttl", options->ttl);
 }
 
 void ffGenerateWeatherJsonResult(FFWeatherOptions* options, yyjson_mut_doc* doc, yyjson_mut_val* module)
@@ -144,6 +159,7 @@ void ffInitWeatherOptions(FFWeatherOptions* options)
     ffStrbufInit(&options->location);
     ffStrbufInitStatic(&options->outputFormat, "%t+-+%C+(%l)");
     options->timeout = 0;
+    options->ttl = 0;
 }
 
 void ffDestroyWeatherOptions(FFWeatherOptions* options)
@@ -21,6 +21,18 @@ static void verify(const char* format, const char* arg, const char* expected, in
 
 #define VERIFY(format, argument, expected) verify((format), (argument), (expected), __LINE__)
 
+static void verifyUsesArg(const char* format, bool expected, int lineNo)
+{
+    FF_STRBUF_AUTO_DESTROY formatter = ffStrbufCreateStatic(format);
+    if (ffFormatStringUsesArg(&formatter, 2, "second") != expected)
+    {
+        fprintf(stderr, FASTFETCH_TEXT_MODIFIER_ERROR "[%d] %s: expected %s\n" FASTFETCH_TEXT_MODIFIER_RESET, lineNo, format, expected ? "true" : "false");
+        exit(1);
+    }
+}
+
+#define VERIFY_USES_ARG(format, expected) verifyUsesArg((format), (expected), __LINE__)
+
 int main(void)
 {
     instance.config.display.pipe = true;
@@ -115,6 +127,22 @@ int main(void)
     VERIFY("output({?1}OK{?}{/1}NOT OK{/})", "", "output(NOT OK)");
     }
 
+    {
+    VERIFY_USES_ARG("output({1})", false);
+    VERIFY_USES_ARG("output({2})", true);
+    VERIFY_USES_ARG("output({})", false);
+    VERIFY_USES_ARG("output({}{})", true);
+    VERIFY_USES_ARG("output({second})", true);
+    VERIFY_USES_ARG("output({SECOND:5})", true);
+    VERIFY_USES_ARG("output({2<10})", true);
+    VERIFY_USES_ARG("output({?second}OK{?})", true);
+    VERIFY_USES_ARG("output({/2}OK{/})", true);
+    VERIFY_USES_ARG("output({?1}{}{?})", false);
+    VERIFY_USES_ARG("output({{2}})", false);
+    VERIFY_USES_ARG("output({secondary})", false);
+    VERIFY_USES_ARG("output({$2}{#2})", false);
+    }
+
     #ifndef _WIN32 // Windows doesn't have setenv
     {
         ffListInit(&instance.config.display.constants, sizeof(FFstrbuf));
@@ -0,0 +1,53 @@
+#include "common/io/io.h"
+#include "util/textModifier.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+
+static void verify(const char* data, const char* expected0, const char* expected1, bool expectedDone, int lineNo)
+{
+    FFTerminalQuery queries[] = {
+        { .request = "\e[18t", .responsePrefix = "\e[8;", .response = ffStrbufCreate() },
+        { .request = "\e]11;?\e\\", .responsePrefix = "\e]11;", .response = ffStrbufCreate() },
+    };
+    FFTerminalReplyParser parser = { .seq = ffStrbufCreate() };
+
+    // Feed one byte at a time, as replies may be split across reads
+    bool done = false;
+    for (const char* p = data; *p && !done; ++p)
+        done = ffTerminalParseReplies(&parser, p, 1, queries, 2);
+
+    if (done != expectedDone || !ffStrbufEqualS(&queries[0].response, expected0) || !ffStrbufEqualS(&queries[1].response, expected1))
+    {
+        fprintf(stderr, FASTFETCH_TEXT_MODIFIER_ERROR "[%d] got \"%s\", \"%s\", %s\n" FASTFETCH_TEXT_MODIFIER_RESET,
+            lineNo, queries[0].response.chars, queries[1].response.chars, done ? "done" : "not done");
+        exit(1);
+    }
+
+    ffStrbufDestroy(&parser.seq);
+    ffStrbufDestroy(&queries[0].response);
+    ffStrbufDestroy(&queries[1].response);
+}
+
+#define VERIFY(data, expected0, expected1, expectedDone) verify((data), (expected0), (expected1), (expectedDone), __LINE__)
+
+int main(void)
+{
+    #define SIZE "\e[8;24;80t"
+    #define BG "\e]11;rgb:1e1e/1e1e/1e1e\e\\"
+    #define DA1 "\e[?61;6;7c"
+
+    VERIFY(SIZE BG DA1, SIZE, BG, true);
+    VERIFY("\e]11;rgb:1e1e/1e1e/1e1e\a" DA1, "", "\e]11;rgb:1e1e/1e1e/1e1e\a", true);
+    VERIFY(BG DA1, "", BG, true); // Unsupported request
+    VERIFY(SIZE BG, SIZE, BG, false); // No DA1 support
+    VERIFY("garbage" SIZE "\e[I" DA1, SIZE, "", true); // Unrelated input and replies
+
+    // Windows Terminal removes all `\e`s
+    VERIFY("[8;24;80t]11;rgb:1e1e/1e1e/1e1e\\[?61;6;7c", SIZE, BG, true);
+    VERIFY("]11;rgb:1e1e/1e1e/1e1e\a[?61;6;7c", "", "\e]11;rgb:1e1e/1e1e/1e1e\a", true);
+    VERIFY("[8;24;80t" BG "[?61;6;7c", SIZE, BG, true);
+
+    //Success
+    puts("\033[32mAll tests passed!" FASTFETCH_TEXT_MODIFIER_RESET);
+}